@@ -0,0 +1,537 @@
+// ECS query benchmark
+// Fills a Handler with a mix of mobs, items and projectiles, then times the queries the game systems run,
+// per entity and through the MovementKernels the systems use. Built once per storage mode, compare
+// farfield_ecs_bench with farfield_ecs_bench_archetype. Also times changed<> queries and projectile respawns through a command buffer.
+// Mobs carry a TickLod like the game's, so part of them catch up on several ticks or sit one out.
+// Fails when a kernel backend disagrees with the per entity code, when FacingSystem reports an unchanged heading as
+// changed, or when commands recorded from parallel queries give different entity ids from one run or thread count to the next
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <fmt/format.h>
+#include <glm/ext/scalar_constants.hpp>
+
+#include "ECS/ISystem.h"
+#include "MovementKernels.h"
+#include "RandomUtils.h"
+#include "Components/Movements.h"
+#include "Components/Gravity.h"
+#include "Components/CollisionBox.h"
+#include "Components/Friction.h"
+#include "Components/TickLod.h"
+#include "Systems/FacingSystem.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+static constexpr int REPETITIONS = 20;
+static constexpr int VALIDATION_STEPS = 4;
+static constexpr float FACING_TOLERANCE = 1e-3f; // Degrees
+
+#ifdef FARFIELD_ECS_ARCHETYPE
+static constexpr auto STORAGE_NAME = "archetype";
+#else
+static constexpr auto STORAGE_NAME = "sparse set";
+#endif
+
+// Best run time of a workload, in nanoseconds per entity it visited
+template<typename Func>
+static double measure(Func&& workload)
+{
+    double best = std::numeric_limits<double>::max();
+    std::size_t visited = 1;
+
+    for (int i = 0; i < REPETITIONS; i++) {
+        const auto start = BenchClock::now();
+        visited = std::max<std::size_t>(1, workload());
+        const double elapsed = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+
+        best = std::min(best, elapsed);
+    }
+    return best / static_cast<double>(visited);
+}
+
+static void populate(ECS::Handler& handler, const std::size_t count)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        const auto entity = handler.createEntity();
+        const auto f = static_cast<float>(i);
+
+        handler.addComponent(entity, ECS::Position{f, 64.f, -f});
+        handler.addComponent(entity, ECS::Velocity{0.01f, 0.f, 0.02f});
+
+        // 1/4 mobs, 1/2 items, 1/4 projectiles
+        switch (i % 4) {
+            case 0: {
+                // Spread over the levels and staggered within them, as the TickLodSystem does
+                const std::size_t mob = i / 4;
+                const auto level = static_cast<std::uint8_t>(mob % (ECS::TickLod::MAX_LEVEL + 1));
+                const auto period = static_cast<std::uint8_t>(1 << level);
+                const auto steps = static_cast<std::uint8_t>(mob / (ECS::TickLod::MAX_LEVEL + 1) % period == 0 ? period : 0);
+
+                handler.addComponent(entity, ECS::Rotation{});
+                handler.addComponent(entity, ECS::Gravity{});
+                handler.addComponent(entity, ECS::CollisionBox{{0.45f, 1.f, 0.3f}});
+                handler.addComponent(entity, ECS::Friction{});
+                handler.addComponent(entity, ECS::TickLod{level, 0, steps});
+                break;
+            }
+            case 1:
+            case 2:
+                handler.addComponent(entity, ECS::Gravity{});
+                handler.addComponent(entity, ECS::CollisionBox{{0.125f, 0.125f, 0.125f}});
+                break;
+            default:
+                handler.addComponent(entity, ECS::Rotation{});
+                break;
+        }
+    }
+}
+
+// Per entity bodies of MovementSystem, GravitySystem and FacingSystem before they moved to MovementKernels.
+// Entities catching up on steps ticks move by vel * steps, gravity runs steps times and facing is skipped on 0
+static void integrateEntity(ECS::Position& pos, const ECS::Velocity& vel, const std::uint8_t steps)
+{
+    pos += static_cast<const glm::vec3&>(vel) * static_cast<float>(steps);
+}
+
+static void applyGravityEntity(ECS::Velocity& vel, const ECS::Gravity& gravity, const ECS::CollisionBox& box)
+{
+    if (box.isGrounded)
+        vel.y = -gravity.strength;
+    else
+        vel.y = glm::max(vel.y - gravity.strength, gravity.terminalVelocity);
+}
+
+static void faceVelocityEntity(ECS::Rotation& rot, const ECS::Velocity& vel)
+{
+    const float hSpeed = std::sqrt(vel.x * vel.x + vel.z * vel.z);
+    if (hSpeed < 0.0001f)
+        return;
+
+    const glm::vec3 dir = normalize(vel);
+    rot.y = glm::degrees(std::atan2(dir.x, dir.z) + glm::pi<float>());
+}
+
+// Random velocities, some entities standing still, some on the ground, random TickLod steps.
+// Handlers populated alike get the same values
+static void randomize(ECS::Handler& handler, const int round)
+{
+    RandomUtils::Stream random = RandomUtils::stream(3120, round, 0, 0, 0);
+
+    handler.query<ECS::Velocity>().forEach([&](ECS::EntityId, ECS::Velocity& vel) {
+        if (random.nextInt(0, 7) == 0)
+            vel = ECS::Velocity{0.f, random.nextFloat() - 0.5f, 0.f};
+        else
+            vel = ECS::Velocity{random.nextFloat() - 0.5f, random.nextFloat() - 0.5f, random.nextFloat() - 0.5f};
+    });
+    handler.query<ECS::CollisionBox>().forEach([&](ECS::EntityId, ECS::CollisionBox& box) {
+        box.isGrounded = random.nextInt(0, 1) == 1;
+    });
+    handler.query<ECS::TickLod>().forEach([&](ECS::EntityId, ECS::TickLod& lod) {
+        lod.level = static_cast<std::uint8_t>(random.nextInt(0, ECS::TickLod::MAX_LEVEL));
+        lod.steps = random.nextInt(0, 1) == 0 ? 0 : static_cast<std::uint8_t>(1 << lod.level);
+    });
+}
+
+// One tick of the three systems through the kernels, the whole chunk at once whether it has a TickLod or not
+static void runKernels(ECS::Handler& handler, const MovementKernels& kernels)
+{
+    handler.query<ECS::Velocity, const ECS::Gravity, const ECS::CollisionBox, ECS::optional<const ECS::TickLod>>().forEachChunk([&](const std::size_t n, const ECS::EntityId*, ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const ECS::TickLod* lods) {
+        if (lods)
+            kernels.applyGravity(vel, gravity, boxes, lods, n);
+        else
+            kernels.applyGravity(vel, gravity, boxes, n);
+    });
+    handler.query<const ECS::Velocity, ECS::Rotation, ECS::optional<const ECS::TickLod>>().forEachChunk([&](const std::size_t n, const ECS::EntityId*, const ECS::Velocity* vel, ECS::Rotation* rot, const ECS::TickLod* lods) {
+        if (lods)
+            kernels.faceVelocity(rot, vel, lods, n);
+        else
+            kernels.faceVelocity(rot, vel, n);
+    });
+    handler.query<ECS::Position, const ECS::Velocity, ECS::optional<const ECS::TickLod>>().forEachChunk([&](const std::size_t n, const ECS::EntityId*, ECS::Position* pos, const ECS::Velocity* vel, const ECS::TickLod* lods) {
+        if (lods)
+            kernels.integrate(pos, vel, lods, n);
+        else
+            kernels.integrate(pos, vel, n);
+    });
+}
+
+// Runs the per entity bodies and one kernel backend on the same entities.
+// Positions and velocities must match bit for bit, rotations within FACING_TOLERANCE
+static bool validate(const std::size_t count, const MovementKernels::Backend backend)
+{
+    ECS::Handler reference(static_cast<std::uint32_t>(count));
+    ECS::Handler batched(static_cast<std::uint32_t>(count));
+    MovementKernels kernels;
+
+    kernels.setBackend(backend);
+    for (ECS::Handler* handler : {&reference, &batched})
+        populate(*handler, count);
+
+    for (int step = 0; step < VALIDATION_STEPS; step++) {
+        for (ECS::Handler* handler : {&reference, &batched})
+            randomize(*handler, step);
+
+        reference.query<ECS::Velocity, const ECS::Gravity, const ECS::CollisionBox, ECS::optional<const ECS::TickLod>>().forEach([](ECS::EntityId, ECS::Velocity& vel, const ECS::Gravity& gravity, const ECS::CollisionBox& box, const ECS::TickLod* lod) {
+            for (std::uint8_t i = 0; i < ECS::getTickSteps(lod); i++)
+                applyGravityEntity(vel, gravity, box);
+        });
+        reference.query<const ECS::Velocity, ECS::Rotation, ECS::optional<const ECS::TickLod>>().forEach([](ECS::EntityId, const ECS::Velocity& vel, ECS::Rotation& rot, const ECS::TickLod* lod) {
+            if (ECS::getTickSteps(lod) > 0)
+                faceVelocityEntity(rot, vel);
+        });
+        reference.query<ECS::Position, const ECS::Velocity, ECS::optional<const ECS::TickLod>>().forEach([](ECS::EntityId, ECS::Position& pos, const ECS::Velocity& vel, const ECS::TickLod* lod) {
+            integrateEntity(pos, vel, ECS::getTickSteps(lod));
+        });
+
+        runKernels(batched, kernels);
+    }
+
+    std::size_t mismatches = 0;
+    float facingError = 0.f;
+
+    reference.query<const ECS::Position, const ECS::Velocity, ECS::optional<const ECS::Rotation>>().forEach([&](const ECS::EntityId id, const ECS::Position& pos, const ECS::Velocity& vel, const ECS::Rotation* rot) {
+        if (pos != batched.getPool<ECS::Position>().get(id) || vel != batched.getPool<ECS::Velocity>().get(id))
+            mismatches++;
+
+        // Angles right below 360 and right above 0 are the same heading
+        if (rot) {
+            const float delta = std::abs(std::remainder(rot->y - batched.getPool<ECS::Rotation>().get(id).y, 360.f));
+            facingError = std::max(facingError, delta);
+        }
+    });
+
+    const bool valid = mismatches == 0 && facingError <= FACING_TOLERANCE;
+
+    fmt::print("    {:<7} kernels | {} position/velocity mismatches | max facing error {:.2e} deg | {}\n",
+        CpuFeatures::getName(kernels.getBackend()), mismatches, facingError, valid ? "ok" : "FAILED");
+    return valid;
+}
+
+// Standing mobs and mobs walking in a constant direction must not show up in changed<Rotation> once they face it,
+// the ones turning must
+static bool validateFacingChanges(const std::size_t count)
+{
+    ECS::Handler handler(static_cast<std::uint32_t>(count));
+    ECS::FacingSystem facing;
+    std::size_t turning = 0;
+
+    for (std::size_t i = 0; i < count; i++) {
+        const auto entity = handler.createEntity();
+
+        // 1/3 standing, 1/3 walking straight, 1/3 turning every tick
+        handler.addComponent(entity, ECS::Velocity{entity.id % 3 == 0 ? 0.f : 0.05f, 0.f, 0.02f});
+        handler.addComponent(entity, ECS::Rotation{});
+        turning += entity.id % 3 == 2;
+    }
+
+    std::size_t mismatches = 0;
+
+    for (int step = 0; step < VALIDATION_STEPS; step++) {
+        const ECS::ChangeTick since = handler.advanceChangeTick();
+
+        handler.advanceChangeTick();
+        handler.query<ECS::Velocity>().forEach([&](const ECS::EntityId id, ECS::Velocity& vel) {
+            if (id % 3 == 2)
+                vel.x = -vel.x;
+        });
+        facing.update(handler, 0.f);
+
+        // The first update turns the walking mobs toward their velocity, the next ones must only see the turning mobs
+        std::size_t changed = 0;
+        handler.query<ECS::changed<ECS::Rotation>>(since).forEach([&](ECS::EntityId) { changed++; });
+
+        if (step > 0 && changed != turning)
+            mismatches++;
+    }
+
+    fmt::print("    facing   | {} turning of {} | {} ticks with other changed<Rotation> | {}\n",
+        turning, count, mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return mismatches == 0;
+}
+
+// Spawns a child of every third entity and destroys every fifth one from the batches of a parallel query
+class SpawnSystem : public ECS::ISystem
+{
+    JobSystem& jobSystem;
+    float tick = 0.f;
+
+    public:
+        explicit SpawnSystem(JobSystem& _jobSystem) : jobSystem(_jobSystem) {}
+
+        void update(ECS::Handler& handler, [[maybe_unused]] float dt) override
+        {
+            this->tick++;
+
+            handler.query<const ECS::Position>().parallelForEach(this->jobSystem, [&](const ECS::EntityId id, const ECS::Position& pos) {
+                ECS::CommandBuffer& commands = handler.getCommands();
+                const auto source = static_cast<int>(pos.x);
+
+                // Lets the workers take batches too, even on a single core
+                if (source % 64 == 0)
+                    std::this_thread::yield();
+
+                if (source % 3 == 0)
+                    commands.addComponent(commands.createEntity(), ECS::Velocity{pos.x, this->tick, 0.f});
+                if (source % 5 == 0)
+                    commands.destroyEntity(handler.getEntity(id));
+            });
+        }
+};
+
+// (source, tick, id) of every spawned entity after a few scheduler updates
+static std::vector<std::tuple<float, float, ECS::EntityId>> spawnChildren(const std::size_t count, const std::size_t threads)
+{
+    JobSystem jobSystem(threads);
+    ECS::SystemScheduler scheduler(jobSystem);
+    ECS::Handler handler(static_cast<std::uint32_t>(count * (VALIDATION_STEPS + 1)));
+
+    for (std::size_t i = 0; i < count; i++)
+        handler.addComponent(handler.createEntity(), ECS::Position{static_cast<float>(i), 0.f, 0.f});
+
+    scheduler.registerSystem<SpawnSystem>(jobSystem);
+    for (int step = 0; step < VALIDATION_STEPS; step++)
+        scheduler.update(handler, 0.f);
+
+    std::vector<std::tuple<float, float, ECS::EntityId>> children;
+    handler.query<const ECS::Velocity>().forEach([&](const ECS::EntityId id, const ECS::Velocity& vel) {
+        children.emplace_back(vel.x, vel.y, id);
+    });
+    std::ranges::sort(children);
+    return children;
+}
+
+// Commands recorded from parallelForEach batches must give the same entity ids whatever thread ran each batch
+static bool validateCommandOrder(const std::size_t count)
+{
+    const auto expected = spawnChildren(count, 1);
+    int mismatches = 0;
+
+    for (const std::size_t threads : {1, 2, 4, 8})
+        for (int run = 0; run < VALIDATION_STEPS; run++)
+            mismatches += spawnChildren(count, threads) != expected;
+
+    fmt::print("    commands | {} children over 1 to 8 threads | {} runs with different ids | {}\n",
+        expected.size(), mismatches, mismatches == 0 ? "ok" : "FAILED");
+    return mismatches == 0;
+}
+
+static bool run(const std::size_t count)
+{
+    ECS::Handler handler(static_cast<std::uint32_t>(count));
+
+    const auto start = BenchClock::now();
+    populate(handler, count);
+    const double populateMs = std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+
+    float checksum = 0.f;
+
+    // Same bodies as MovementSystem, GravitySystem, FacingSystem and the PlayerMovementSystem friction, without the world lookups.
+    // The first three are timed per entity and through the kernels
+    const double movement = measure([&] {
+        std::size_t visited = 0;
+        handler.query<ECS::Position, const ECS::Velocity, ECS::without<ECS::CollisionBox>>().forEach([&](ECS::EntityId, ECS::Position& pos, const ECS::Velocity& vel) {
+            integrateEntity(pos, vel, 1);
+            visited++;
+        });
+        return visited;
+    });
+
+    const double gravity = measure([&] {
+        std::size_t visited = 0;
+        handler.query<ECS::Velocity, const ECS::Gravity, const ECS::CollisionBox, ECS::optional<const ECS::TickLod>>().forEach([&](ECS::EntityId, ECS::Velocity& vel, const ECS::Gravity& g, const ECS::CollisionBox& box, const ECS::TickLod* lod) {
+            for (std::uint8_t i = 0; i < ECS::getTickSteps(lod); i++)
+                applyGravityEntity(vel, g, box);
+            visited++;
+        });
+        return visited;
+    });
+
+    const double facing = measure([&] {
+        std::size_t visited = 0;
+        handler.query<const ECS::Velocity, ECS::Rotation, ECS::optional<const ECS::TickLod>>().forEach([&](ECS::EntityId, const ECS::Velocity& vel, ECS::Rotation& rot, const ECS::TickLod* lod) {
+            if (ECS::getTickSteps(lod) > 0)
+                faceVelocityEntity(rot, vel);
+            visited++;
+        });
+        return visited;
+    });
+
+    const double friction = measure([&] {
+        std::size_t visited = 0;
+        handler.query<ECS::Velocity, const ECS::CollisionBox, ECS::optional<const ECS::Friction>>().forEach([&](ECS::EntityId, ECS::Velocity& vel, const ECS::CollisionBox& box, const ECS::Friction* frictions) {
+            float factor = 0.8f;
+
+            if (frictions)
+                factor = box.isGrounded ? frictions->ground : frictions->air;
+            vel.x *= factor;
+            vel.z *= factor;
+            visited++;
+        });
+        return visited;
+    });
+
+    fmt::print("{:>7} entities | populate {:>8.2f} ms | movement {:>6.2f} ns | gravity {:>6.2f} ns | facing {:>6.2f} ns | friction {:>6.2f} ns\n",
+        count, populateMs, movement, gravity, facing, friction);
+
+    bool valid = true;
+    const MovementKernels::Backend best = CpuFeatures::detectSimdLevel();
+
+    for (auto backend = MovementKernels::Backend::SCALAR; backend <= best; backend = static_cast<MovementKernels::Backend>(static_cast<int>(backend) + 1)) {
+        MovementKernels kernels;
+        kernels.setBackend(backend);
+
+        const double movementKernel = measure([&] {
+            std::size_t visited = 0;
+            handler.query<ECS::Position, const ECS::Velocity, ECS::without<ECS::CollisionBox>>().forEachChunk([&](const std::size_t n, const ECS::EntityId*, ECS::Position* pos, const ECS::Velocity* vel) {
+                kernels.integrate(pos, vel, n);
+                visited += n;
+            });
+            return visited;
+        });
+
+        const double gravityKernel = measure([&] {
+            std::size_t visited = 0;
+            handler.query<ECS::Velocity, const ECS::Gravity, const ECS::CollisionBox, ECS::optional<const ECS::TickLod>>().forEachChunk([&](const std::size_t n, const ECS::EntityId*, ECS::Velocity* vel, const ECS::Gravity* g, const ECS::CollisionBox* boxes, const ECS::TickLod* lods) {
+                if (lods)
+                    kernels.applyGravity(vel, g, boxes, lods, n);
+                else
+                    kernels.applyGravity(vel, g, boxes, n);
+                visited += n;
+            });
+            return visited;
+        });
+
+        const double facingKernel = measure([&] {
+            std::size_t visited = 0;
+            handler.query<const ECS::Velocity, ECS::Rotation, ECS::optional<const ECS::TickLod>>().forEachChunk([&](const std::size_t n, const ECS::EntityId*, const ECS::Velocity* vel, ECS::Rotation* rot, const ECS::TickLod* lods) {
+                if (lods)
+                    kernels.faceVelocity(rot, vel, lods, n);
+                else
+                    kernels.faceVelocity(rot, vel, n);
+                visited += n;
+            });
+            return visited;
+        });
+
+        fmt::print("    {:<7} kernels | movement {:>6.2f} ns | gravity {:>6.2f} ns | facing {:>6.2f} ns\n",
+            CpuFeatures::getName(backend), movementKernel, gravityKernel, facingKernel);
+        valid = validate(count, backend) && valid;
+    }
+
+    // One boxed entity in a hundred moves, the grid rebuild check scans everything or only what changed since
+    const ECS::ChangeTick since = handler.advanceChangeTick();
+    std::size_t boxed = 0;
+    std::size_t moved = 0;
+
+    handler.advanceChangeTick();
+    handler.query<const ECS::CollisionBox>().forEach([&](const ECS::EntityId id, const ECS::CollisionBox&) {
+        if (boxed++ % 100 == 0) {
+            handler.markChanged<ECS::Position>(id);
+            moved++;
+        }
+    });
+
+    std::size_t scanned = 0;
+    std::size_t changed = 0;
+
+    const double scanAll = measure([&] {
+        scanned = 0;
+        handler.query<const ECS::Position, const ECS::CollisionBox>().forEach([&](ECS::EntityId, const ECS::Position& pos, const ECS::CollisionBox&) {
+            checksum += pos.y;
+            scanned++;
+        });
+        return boxed;
+    });
+
+    const double scanChanged = measure([&] {
+        changed = 0;
+        handler.query<const ECS::Position, ECS::changed<ECS::Position>, const ECS::CollisionBox>(since).forEach([&](ECS::EntityId, const ECS::Position& pos, const ECS::CollisionBox&) {
+            checksum += pos.y;
+            changed++;
+        });
+        return boxed;
+    });
+
+    // Nothing changed since the last mark, what the grid system checks on a tick where everything stands still
+    const ECS::ChangeTick idleSince = handler.getChangeTick();
+    std::size_t idleChanged = 0;
+
+    const double scanIdle = measure([&] {
+        handler.query<ECS::changed<ECS::Position>, const ECS::CollisionBox>(idleSince).forEach([&](ECS::EntityId, const ECS::CollisionBox&) { idleChanged++; });
+        return boxed;
+    });
+
+    if (scanned != boxed || changed != moved || idleChanged != 0) {
+        fmt::print("    changed query found {} of {} moved entities\n", changed, moved);
+        valid = false;
+    }
+    fmt::print("    changes  | scan all {:>6.2f} ns | changed<Position> {:>6.2f} ns | nothing changed {:>6.2f} ns | per boxed entity, {} moved\n",
+        scanAll, scanChanged, scanIdle, moved);
+
+    handler.query<const ECS::Position>().forEach([&](ECS::EntityId, const ECS::Position& pos) { checksum += pos.x; });
+    fmt::print("    checksum {:.0f}\n", checksum);
+
+    // Every projectile is replaced by a new one: destroy, create and 3 adds recorded during the query, applied after it
+    const auto recordRespawns = [&] {
+        ECS::CommandBuffer& commands = handler.getCommands();
+
+        handler.query<const ECS::Position, const ECS::Velocity, ECS::without<ECS::CollisionBox>>().forEach([&](const ECS::EntityId id, const ECS::Position& pos, const ECS::Velocity& vel) {
+            const ECS::PendingEntity spawned = commands.createEntity();
+
+            commands.destroyEntity(handler.getEntity(id));
+            commands.addComponent(spawned, pos);
+            commands.addComponent(spawned, vel);
+            commands.addComponent(spawned, ECS::Rotation{});
+        });
+        return commands.size();
+    };
+
+    const std::size_t projectiles = handler.getPool<ECS::Rotation>().size();
+
+    const double record = measure([&] {
+        const std::size_t recorded = recordRespawns();
+        handler.getCommands().clear();
+        return recorded;
+    });
+
+    const double respawn = measure([&] {
+        const std::size_t recorded = recordRespawns();
+        handler.applyCommands();
+        return recorded;
+    });
+
+    if (handler.getPool<ECS::Rotation>().size() != projectiles) {
+        fmt::print("    respawns changed the entity count\n");
+        valid = false;
+    }
+    fmt::print("    commands | record {:>6.2f} ns | record and apply {:>6.2f} ns | per command\n", record, respawn);
+
+    valid = validateFacingChanges(count) && valid;
+    return validateCommandOrder(count) && valid;
+}
+
+int main(const int argc, char** argv)
+{
+    std::vector<std::size_t> counts{10'000, 100'000};
+
+    if (argc > 1) {
+        counts.clear();
+        for (int i = 1; i < argc; i++)
+            counts.push_back(std::stoul(argv[i]));
+    }
+
+    fmt::print("ECS queries, {} storage, best of {} runs, time per matched entity\n", STORAGE_NAME, REPETITIONS);
+
+    bool valid = true;
+    for (const std::size_t count : counts)
+        valid = run(count) && valid;
+    return valid ? 0 : 1;
+}
\ No newline at end of file
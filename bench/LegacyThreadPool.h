@@ -1,8 +1,10 @@
-#ifndef FARFIELD_THREADPOOL_H
-#define FARFIELD_THREADPOOL_H
+#ifndef FARFIELD_LEGACYTHREADPOOL_H
+#define FARFIELD_LEGACYTHREADPOOL_H
 
 #pragma once
 
+// The per-subsystem pool JobSystem replaced, kept as is for the scheduler comparison of the world generation benchmark
+
 #include <queue>
 #include <thread>
 #include <mutex>
@@ -12,10 +14,10 @@
 #include <atomic>
 
 template<typename Job>
-class ThreadPool {
+class LegacyThreadPool {
 public:
-    explicit ThreadPool(size_t n);
-    ~ThreadPool();
+    explicit LegacyThreadPool(size_t n);
+    ~LegacyThreadPool();
 
     void enqueue(Job job);
     void setWorker(std::function<void(Job)> fn);
@@ -32,25 +34,25 @@ private:
 };
 
 template<typename Job>
-ThreadPool<Job>::ThreadPool(size_t n) {
+LegacyThreadPool<Job>::LegacyThreadPool(size_t n) {
     for (size_t i = 0; i < n; ++i)
-        threads.emplace_back(&ThreadPool::loop, this);
+        threads.emplace_back(&LegacyThreadPool::loop, this);
 }
 
 template<typename Job>
-ThreadPool<Job>::~ThreadPool() {
+LegacyThreadPool<Job>::~LegacyThreadPool() {
     running = false;
     cv.notify_all();
     for (auto& t : threads) t.join();
 }
 
 template<typename Job>
-void ThreadPool<Job>::setWorker(std::function<void(Job)> fn) {
+void LegacyThreadPool<Job>::setWorker(std::function<void(Job)> fn) {
     worker = fn;
 }
 
 template<typename Job>
-void ThreadPool<Job>::enqueue(Job job) {
+void LegacyThreadPool<Job>::enqueue(Job job) {
     {
         std::lock_guard lock(mutex);
         jobs.push(job);
@@ -59,7 +61,7 @@ void ThreadPool<Job>::enqueue(Job job) {
 }
 
 template<typename Job>
-void ThreadPool<Job>::loop() {
+void LegacyThreadPool<Job>::loop() {
     while (running) {
         Job job;
         {
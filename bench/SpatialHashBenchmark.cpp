@@ -0,0 +1,203 @@
+// Entity broadphase benchmark
+// Scatters entity boxes at a constant density and times the queries the game runs on them
+// (isEntityAt boxes, radius, Raycast rays, one push-apart pass), through the spatial hash and by linear scan.
+// Both must find the same entities, the benchmark fails otherwise
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "SpatialHash.h"
+#include "RandomUtils.h"
+
+using BenchClock = std::chrono::steady_clock;
+
+static constexpr int REPETITIONS = 5;
+static constexpr int QUERY_COUNT = 10'000;
+static constexpr float AREA_PER_ENTITY = 16.f; // Blocks on the ground per entity
+static constexpr float RADIUS = 4.f;
+static constexpr float RAY_LENGTH = 6.f;
+
+// Linear scans are quadratic for the push pass, they're skipped past this count
+static constexpr std::size_t MAX_LINEAR_PUSH = 10'000;
+
+struct Box {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+struct Query {
+    glm::vec3 pos;
+    glm::vec3 dir;
+};
+
+// Best run time of a workload, in nanoseconds per query
+template<typename Func>
+static double measure(const std::size_t queries, uint64_t& found, Func&& workload)
+{
+    double best = std::numeric_limits<double>::max();
+
+    for (int i = 0; i < REPETITIONS; i++) {
+        const auto start = BenchClock::now();
+        found = workload();
+        const double elapsed = std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+
+        best = std::min(best, elapsed);
+    }
+    return best / static_cast<double>(queries);
+}
+
+static bool overlaps(const Box& a, const glm::vec3& min, const glm::vec3& max)
+{
+    return a.min.x < max.x && a.max.x > min.x && a.min.y < max.y && a.max.y > min.y && a.min.z < max.z && a.max.z > min.z;
+}
+
+static bool withinRadius(const Box& box, const glm::vec3& center)
+{
+    const glm::vec3 delta = glm::clamp(center, box.min, box.max) - center;
+    return glm::dot(delta, delta) < RADIUS * RADIUS;
+}
+
+static glm::vec3 rayMin(const Query& q) { return glm::min(q.pos, q.pos + q.dir * RAY_LENGTH) - 1e-3f; }
+static glm::vec3 rayMax(const Query& q) { return glm::max(q.pos, q.pos + q.dir * RAY_LENGTH) + 1e-3f; }
+
+static bool run(const std::size_t count)
+{
+    const float side = std::sqrt(static_cast<float>(count) * AREA_PER_ENTITY);
+    RandomUtils::Stream random = RandomUtils::stream(3120, static_cast<int>(count), 0, 0, 0);
+
+    std::vector<Box> boxes;
+    boxes.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        const glm::vec3 feet{random.nextFloat() * side, 64.f + random.nextFloat() * 4.f, random.nextFloat() * side};
+        const glm::vec3 half = i % 2 == 0 ? glm::vec3{0.45f, 1.f, 0.3f} : glm::vec3{0.125f, 0.125f, 0.125f};
+
+        boxes.push_back({{feet.x - half.x, feet.y, feet.z - half.z}, {feet.x + half.x, feet.y + half.y * 2.f, feet.z + half.z}});
+    }
+
+    std::vector<Query> queries;
+    queries.reserve(QUERY_COUNT);
+
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        const glm::vec3 pos{random.nextFloat() * side, 64.f + random.nextFloat() * 4.f, random.nextFloat() * side};
+        const glm::vec3 dir = glm::normalize(glm::vec3{random.nextFloat() - 0.5f, random.nextFloat() - 0.5f, random.nextFloat() - 0.5f} + 1e-3f);
+
+        queries.push_back({glm::floor(pos), dir});
+    }
+
+    SpatialHash grid;
+    uint64_t ignored = 0;
+
+    const double build = measure(1, ignored, [&] {
+        grid.clear();
+        for (std::size_t i = 0; i < count; i++)
+            grid.insert(static_cast<ECS::EntityId>(i), boxes[i].min, boxes[i].max);
+        grid.build();
+        return uint64_t{0};
+    }) / 1e6;
+
+    // Hash and linear results are summed ids, so a missed or repeated entity changes the checksum
+    uint64_t hashFound = 0;
+    uint64_t linearFound = 0;
+    bool valid = true;
+
+    const auto report = [&](const std::string& name, const std::size_t queryCount, const auto& hashQuery, const auto& linearQuery, const bool runLinear) {
+        const double hashNs = measure(queryCount, hashFound, hashQuery);
+        std::string linear = "-";
+
+        if (runLinear) {
+            const double linearNs = measure(queryCount, linearFound, linearQuery);
+            linear = fmt::format("{:.0f} ns", linearNs);
+
+            if (hashFound != linearFound) {
+                fmt::print("    {} mismatch : {} found by the hash, {} by linear scan\n", name, hashFound, linearFound);
+                valid = false;
+            }
+        }
+        fmt::print("    {:<8} hash {:>8.1f} ns | linear {:>10} | per query\n", name, hashNs, linear);
+    };
+
+    fmt::print("{:>6} entities | {:.0f}x{:.0f} blocks | build {:.3f} ms\n", count, side, side, build);
+
+    report("box", QUERY_COUNT, [&] {
+        uint64_t sum = 0;
+        for (const Query& q : queries)
+            grid.queryBox(q.pos, q.pos + 1.f, [&](const SpatialHash::Entry& e) { sum += e.id + 1; });
+        return sum;
+    }, [&] {
+        uint64_t sum = 0;
+        for (const Query& q : queries)
+            for (std::size_t i = 0; i < count; i++)
+                if (overlaps(boxes[i], q.pos, q.pos + 1.f))
+                    sum += i + 1;
+        return sum;
+    }, true);
+
+    report("radius", QUERY_COUNT, [&] {
+        uint64_t sum = 0;
+        for (const Query& q : queries)
+            grid.queryRadius(q.pos, RADIUS, [&](const SpatialHash::Entry& e) { sum += e.id + 1; });
+        return sum;
+    }, [&] {
+        uint64_t sum = 0;
+        for (const Query& q : queries)
+            for (std::size_t i = 0; i < count; i++)
+                if (overlaps(boxes[i], q.pos - RADIUS, q.pos + RADIUS) && withinRadius(boxes[i], q.pos))
+                    sum += i + 1;
+        return sum;
+    }, true);
+
+    report("ray", QUERY_COUNT, [&] {
+        uint64_t sum = 0;
+        for (const Query& q : queries)
+            grid.queryRay(q.pos, q.dir, RAY_LENGTH, [&](const SpatialHash::Entry& e) { sum += e.id + 1; });
+        return sum;
+    }, [&] {
+        uint64_t sum = 0;
+        for (const Query& q : queries)
+            for (std::size_t i = 0; i < count; i++)
+                if (overlaps(boxes[i], rayMin(q), rayMax(q)))
+                    sum += i + 1;
+        return sum;
+    }, true);
+
+    report("push", count, [&] {
+        uint64_t pairs = 0;
+        for (const Box& box : boxes)
+            grid.queryBox(box.min, box.max, [&](const SpatialHash::Entry&) { pairs++; });
+        return pairs;
+    }, [&] {
+        uint64_t pairs = 0;
+        for (const Box& box : boxes)
+            for (const Box& other : boxes)
+                if (overlaps(other, box.min, box.max))
+                    pairs++;
+        return pairs;
+    }, count <= MAX_LINEAR_PUSH);
+
+    return valid;
+}
+
+int main(const int argc, char** argv)
+{
+    std::vector<std::size_t> counts{1'000, 5'000, 10'000, 50'000};
+
+    if (argc > 1) {
+        counts.clear();
+        for (int i = 1; i < argc; i++)
+            counts.push_back(std::stoul(argv[i]));
+    }
+
+    fmt::print("Entity broadphase, cell size {}, best of {} runs\n", SpatialHash::DEFAULT_CELL_SIZE, REPETITIONS);
+
+    bool valid = true;
+    for (const std::size_t count : counts)
+        valid = run(count) && valid;
+    return valid ? 0 : 1;
+}
@@ -0,0 +1,495 @@
+// Headless world generation benchmark
+// Generates and decorates a region for each thread count, reports throughput and step latencies,
+// and checks every chunk's content against the golden hashes of the fixed seed
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "ChunkManager.h"
+#include "LegacyThreadPool.h"
+
+struct BenchOptions {
+    int size = 6;                 // Region width and depth in chunks
+    int height = 6;               // Region height in chunks
+    std::vector<std::size_t> threads{1, 2, 4};
+    TerrainMode mode = TerrainMode::HEIGHTMAP;
+    std::string golden;           // Golden file, defaults to the one of the terrain mode
+    bool updateGolden = false;
+    bool densityBaseline = false; // Times the density lattice against per-block sampling instead
+    bool schedulerBaseline = false; // Times JobSystem against the per-subsystem pools it replaced instead
+    int runs = 7;                   // Runs per thread count of the scheduler comparison, the median is reported
+    int timeoutSeconds = 120;
+};
+
+using ChunkHashes = std::map<std::tuple<int, int, int>, uint64_t>;
+
+// Generation steps of a chunk reach up to 2 chunks away, so the region is padded to let its edges finish
+static constexpr int REGION_MARGIN = 2;
+
+static std::vector<std::size_t> parseThreads(const std::string& list)
+{
+    std::vector<std::size_t> threads;
+    std::stringstream stream(list);
+    std::string item;
+
+    while (std::getline(stream, item, ','))
+        threads.push_back(std::max(1, std::stoi(item)));
+    return threads;
+}
+
+static BenchOptions parseOptions(const int argc, char** argv)
+{
+    BenchOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const auto value = [&]() -> std::string {
+            if (i + 1 >= argc)
+                throw std::runtime_error("[WorldGenBenchmark] Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--size")
+            options.size = std::stoi(value());
+        else if (arg == "--height")
+            options.height = std::stoi(value());
+        else if (arg == "--threads")
+            options.threads = parseThreads(value());
+        else if (arg == "--mode")
+            options.mode = value() == "density" ? TerrainMode::DENSITY : TerrainMode::HEIGHTMAP;
+        else if (arg == "--golden")
+            options.golden = value();
+        else if (arg == "--update-golden")
+            options.updateGolden = true;
+        else if (arg == "--timeout")
+            options.timeoutSeconds = std::stoi(value());
+        else if (arg == "--density-baseline")
+            options.densityBaseline = true;
+        else if (arg == "--scheduler-baseline")
+            options.schedulerBaseline = true;
+        else if (arg == "--runs")
+            options.runs = std::max(1, std::stoi(value()));
+        else
+            throw std::runtime_error("[WorldGenBenchmark] Unknown option : " + arg);
+    }
+
+    if (options.golden.empty())
+        options.golden = std::string(BENCH_PATH) + "golden/worldgen_" + (options.mode == TerrainMode::DENSITY ? "density" : "heightmap") + ".txt";
+    return options;
+}
+
+// FNV-1a over the raw materials, independent of the palette layout
+static uint64_t hashChunk(const Chunk& chunk)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (const Material mat : chunk.getBlockSnapshot()) {
+        hash ^= mat.data;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static ChunkHashes loadGolden(const std::string& path)
+{
+    ChunkHashes hashes;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream stream(line);
+        int x, y, z;
+        std::string hash;
+
+        if (stream >> x >> y >> z >> hash)
+            hashes[{x, y, z}] = std::stoull(hash, nullptr, 16);
+    }
+    return hashes;
+}
+
+static void saveGolden(const std::string& path, const ChunkHashes& hashes)
+{
+    std::ofstream file(path);
+
+    if (!file)
+        throw std::runtime_error("[WorldGenBenchmark] Can't write golden file : " + path);
+
+    file << "# x y z content hash, fixed seed world generation\n";
+    for (const auto& [pos, hash] : hashes) {
+        const auto [x, y, z] = pos;
+        file << fmt::format("{} {} {} {:016x}\n", x, y, z, hash);
+    }
+}
+
+// Percentile over every step run, merging the step histograms
+static double getPercentileMs(const GenerationPipeline& pipeline, const double p)
+{
+    std::array<uint64_t, StepMetrics::BUCKET_COUNT> buckets{};
+    uint64_t count = 0;
+
+    for (std::size_t step = 0; step < pipeline.getStepCount(); step++) {
+        const auto& metrics = pipeline.getMetrics(step);
+
+        for (std::size_t i = 0; i < StepMetrics::BUCKET_COUNT; i++) {
+            const uint64_t n = metrics.buckets[i].load(std::memory_order_relaxed);
+            buckets[i] += n;
+            count += n;
+        }
+    }
+
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * static_cast<double>(count))));
+    uint64_t seen = 0;
+
+    for (std::size_t i = 0; i < StepMetrics::BUCKET_COUNT; i++) {
+        seen += buckets[i];
+        if (seen >= rank)
+            return static_cast<double>(StepMetrics::getBucketMidpoint(i)) / 1e6;
+    }
+    return 0.0;
+}
+
+static bool isMeasured(const BenchOptions& options, const ChunkPos& pos)
+{
+    return pos.x >= 0 && pos.x < options.size && pos.z >= 0 && pos.z < options.size && pos.y >= 0 && pos.y < options.height;
+}
+
+static ChunkHashes runPass(const BenchOptions& options, const BlockRegistry& blockRegistry, const PrefabRegistry& prefabRegistry, const std::size_t threadCount)
+{
+    Settings settings;
+    settings.setTerrainMode(options.mode);
+
+    JobSystem jobSystem(threadCount);
+    ChunkManager chunkManager(blockRegistry, prefabRegistry, settings, jobSystem);
+
+    const auto start = std::chrono::steady_clock::now();
+    const int measured = options.size * options.size * options.height;
+
+    for (int z = -REGION_MARGIN; z < options.size + REGION_MARGIN; z++)
+        for (int y = 0; y < options.height + REGION_MARGIN; y++)
+            for (int x = -REGION_MARGIN; x < options.size + REGION_MARGIN; x++)
+                chunkManager.requestChunk({x, y, z});
+
+    // Wait for every measured chunk to be decorated
+    while (true) {
+        int done = 0;
+        {
+            auto lock = chunkManager.acquireReadLock();
+
+            for (const auto& [pos, chunk] : chunkManager.getChunks())
+                if (isMeasured(options, pos) && chunk->getState() >= ChunkState::GENERATED)
+                    done++;
+        }
+
+        if (done == measured)
+            break;
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(options.timeoutSeconds))
+            throw std::runtime_error(fmt::format("[WorldGenBenchmark] Timed out with {}/{} chunks generated", done, measured));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto& pipeline = chunkManager.getPipeline();
+
+    fmt::print("threads {:>2} | {:>8.1f} chunks/s | {:>8.1f} ms | job p50 {:.3f} ms, p99 {:.3f} ms\n",
+        threadCount, measured / seconds, seconds * 1e3, getPercentileMs(pipeline, 0.5), getPercentileMs(pipeline, 0.99));
+
+    for (std::size_t step = 0; step < pipeline.getStepCount(); step++) {
+        const auto& metrics = pipeline.getMetrics(step);
+
+        fmt::print("    {:<20} {:>6} runs | avg {:.3f} ms, p50 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms\n",
+            pipeline.getStepName(step), metrics.runCount.load(), metrics.getAverageMs(),
+            metrics.getPercentileMs(0.5), metrics.getPercentileMs(0.99), metrics.getMaxMs());
+    }
+
+    ChunkHashes hashes;
+    auto lock = chunkManager.acquireReadLock();
+
+    for (const auto& [pos, chunk] : chunkManager.getChunks())
+        if (isMeasured(options, pos))
+            hashes[{pos.x, pos.y, pos.z}] = hashChunk(*chunk);
+    return hashes;
+}
+
+// Density terrain on one thread: the lattice path of TerrainGenerator against sampling the density at every block,
+// the approach the lattice replaced. Both classify the same extra layer above the chunk and write the same block count
+static void runDensityBaseline(const BenchOptions& options, const BlockRegistry& blockRegistry, const PrefabRegistry& prefabRegistry)
+{
+    using Clock = std::chrono::steady_clock;
+
+    TerrainGenerator generator(blockRegistry, prefabRegistry, TerrainMode::DENSITY);
+    const Material air = Material::pack(blockRegistry.getByName("core:air"), 0);
+    const Material dirt = Material::pack(blockRegistry.getByName("core:dirt"), 0);
+    const Material grass = Material::pack(blockRegistry.getByName("core:grass"), 0);
+
+    std::vector<std::unique_ptr<Chunk>> lattice;
+    std::vector<std::unique_ptr<Chunk>> perBlock;
+
+    for (int z = 0; z < options.size; z++)
+        for (int y = 0; y < options.height; y++)
+            for (int x = 0; x < options.size; x++) {
+                lattice.push_back(std::make_unique<Chunk>(ChunkPos{x, y, z}, blockRegistry));
+                perBlock.push_back(std::make_unique<Chunk>(ChunkPos{x, y, z}, blockRegistry));
+            }
+
+    // Lattices are computed on first use and kept for the neighbors reading their faces, like in the pipeline
+    for (int z = 0; z <= options.size; z++)
+        for (int y = 0; y <= options.height; y++)
+            for (int x = 0; x <= options.size; x++)
+                generator.retainChunk({x, y, z});
+
+    auto start = Clock::now();
+    for (const auto& chunk : lattice)
+        generator.generate(*chunk);
+    const double latticeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (const auto& chunk : perBlock) {
+        const auto [cx, cy, cz] = chunk->getPosition();
+        std::array<Material, Chunk::SIZE> blocks;
+
+        for (int z = 0; z < Chunk::SIZE; z++)
+            for (int x = 0; x < Chunk::SIZE; x++) {
+                const int wx = cx * Chunk::SIZE + x;
+                const int wz = cz * Chunk::SIZE + z;
+                bool above = generator.sampleDensity(wx, cy * Chunk::SIZE + Chunk::SIZE, wz) > 0;
+
+                for (int y = Chunk::SIZE - 1; y >= 0; y--) {
+                    const bool solid = generator.sampleDensity(wx, cy * Chunk::SIZE + y, wz) > 0;
+
+                    blocks[y] = !solid ? air : above ? dirt : grass;
+                    above = solid;
+                }
+                chunk->setColumnDirect(x, z, blocks);
+            }
+    }
+    const double perBlockMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // How often the interpolated solidity matches the exact one
+    uint64_t agreeing = 0;
+    uint64_t total = 0;
+
+    for (std::size_t i = 0; i < lattice.size(); i++)
+        for (int z = 0; z < Chunk::SIZE; z++)
+            for (int y = 0; y < Chunk::SIZE; y++)
+                for (int x = 0; x < Chunk::SIZE; x++) {
+                    const bool a = lattice[i]->getBlock(x, y, z).data != air.data;
+                    const bool b = perBlock[i]->getBlock(x, y, z).data != air.data;
+
+                    agreeing += a == b;
+                    total++;
+                }
+
+    const auto chunks = static_cast<double>(lattice.size());
+    fmt::print("density lattice   | {:>8.1f} ms | {:.3f} ms/chunk\n", latticeMs, latticeMs / chunks);
+    fmt::print("density per block | {:>8.1f} ms | {:.3f} ms/chunk ({:.1f}x the lattice)\n", perBlockMs, perBlockMs / chunks, perBlockMs / latticeMs);
+    fmt::print("solidity matching the per block density: {:.2f}%\n", 100.0 * static_cast<double>(agreeing) / static_cast<double>(total));
+}
+
+// Chunks missing from the golden file are reported but don't fail, so a larger region can still run
+static int compareGolden(const ChunkHashes& golden, const ChunkHashes& hashes, const std::size_t threadCount)
+{
+    int mismatches = 0;
+    int unchecked = 0;
+
+    for (const auto& [pos, hash] : hashes) {
+        const auto it = golden.find(pos);
+
+        if (it == golden.end()) {
+            unchecked++;
+            continue;
+        }
+        if (it->second != hash) {
+            const auto [x, y, z] = pos;
+            fmt::print("    mismatch at {} {} {} : {:016x}, expected {:016x}\n", x, y, z, hash, it->second);
+            mismatches++;
+        }
+    }
+
+    fmt::print("threads {:>2} | golden {} checked, {} mismatched, {} unchecked\n",
+        threadCount, hashes.size() - unchecked, mismatches, unchecked);
+    return mismatches;
+}
+
+// Scheduler comparison: the generation steps of the padded region, queued through the two pools of N threads
+// ChunkManager used to own (terrain, decoration) or through one JobSystem of N workers.
+// Steps run in waves, every chunk finishing a step before any starts the next, so both schedulers get the same jobs
+struct SchedulerJob {
+    ChunkPos pos;
+    float distance;
+    uint8_t step;
+
+    bool operator<(const SchedulerJob& other) const {
+        return distance > other.distance;
+    }
+};
+
+enum class Scheduler { THREAD_POOLS, JOB_SYSTEM };
+
+static double runSchedulerPass(const BenchOptions& options, const BlockRegistry& blockRegistry, const PrefabRegistry& prefabRegistry,
+    const Scheduler scheduler, const std::size_t threadCount, ChunkHashes& hashes)
+{
+    TerrainGenerator generator(blockRegistry, prefabRegistry, options.mode);
+    GenerationPipeline pipeline;
+    generator.buildPipeline(pipeline);
+
+    ChunkMap chunks;
+    for (int z = -REGION_MARGIN; z < options.size + REGION_MARGIN; z++)
+        for (int y = 0; y < options.height + REGION_MARGIN; y++)
+            for (int x = -REGION_MARGIN; x < options.size + REGION_MARGIN; x++) {
+                const ChunkPos pos{x, y, z};
+                auto chunk = std::make_unique<Chunk>(pos, blockRegistry);
+
+                chunk->setState(ChunkState::GENERATING);
+                generator.retainChunk(pos);
+                chunks.emplace(pos, std::move(chunk));
+            }
+
+    const GenerationPipeline::ChunkGetter getChunk = [&chunks](const ChunkPos& pos) -> Chunk* {
+        const auto it = chunks.find(pos);
+        return it == chunks.end() ? nullptr : it->second.get();
+    };
+
+    std::atomic<std::size_t> remaining{0};
+    const auto runJob = [&](const SchedulerJob& job) {
+        pipeline.runStep(job.step, *chunks.at(job.pos), getChunk);
+
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            remaining.notify_one();
+    };
+
+    // Pools are built like the old ChunkManager did, before the clock starts, so are the JobSystem workers
+    std::unique_ptr<LegacyThreadPool<SchedulerJob>> terrainWorkers;
+    std::unique_ptr<LegacyThreadPool<SchedulerJob>> decorationWorkers;
+    std::unique_ptr<JobSystem> jobSystem;
+
+    if (scheduler == Scheduler::THREAD_POOLS) {
+        terrainWorkers = std::make_unique<LegacyThreadPool<SchedulerJob>>(threadCount);
+        decorationWorkers = std::make_unique<LegacyThreadPool<SchedulerJob>>(threadCount);
+        terrainWorkers->setWorker(runJob);
+        decorationWorkers->setWorker(runJob);
+    }
+    else
+        jobSystem = std::make_unique<JobSystem>(threadCount);
+
+    const auto jobHandler = [](void* context, const Job& job) {
+        (*static_cast<decltype(runJob)*>(context))(job.get<SchedulerJob>());
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t step = 0; step < pipeline.getStepCount(); step++) {
+        const bool terrain = pipeline.getStepPriority(step) == JobPriority::TERRAIN;
+        remaining.store(chunks.size(), std::memory_order_release);
+
+        for (const auto& pos : chunks | std::views::keys) {
+            const float distance = std::abs(pos.x - options.size / 2.f) + std::abs(pos.z - options.size / 2.f) + static_cast<float>(pos.y);
+            const SchedulerJob job{pos, distance, static_cast<uint8_t>(step)};
+
+            if (scheduler == Scheduler::THREAD_POOLS)
+                (terrain ? terrainWorkers : decorationWorkers)->enqueue(job);
+            else
+                jobSystem->submit(pipeline.getStepPriority(step), Job::make(jobHandler, const_cast<void*>(static_cast<const void*>(&runJob)), distance, job));
+        }
+
+        for (std::size_t left = remaining.load(std::memory_order_acquire); left != 0; left = remaining.load(std::memory_order_acquire))
+            remaining.wait(left, std::memory_order_acquire);
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& [pos, chunk] : chunks)
+        if (isMeasured(options, pos)) {
+            chunk->finalizeGeneration();
+            hashes[{pos.x, pos.y, pos.z}] = hashChunk(*chunk);
+        }
+    return ms;
+}
+
+static int runSchedulerBaseline(const BenchOptions& options, const BlockRegistry& blockRegistry, const PrefabRegistry& prefabRegistry, const ChunkHashes& golden)
+{
+    const auto median = [](std::vector<double> values) {
+        std::ranges::sort(values);
+        return values[values.size() / 2];
+    };
+
+    int failures = 0;
+
+    for (const std::size_t threadCount : options.threads) {
+        std::vector<double> pools;
+        std::vector<double> jobs;
+        ChunkHashes poolHashes;
+        ChunkHashes jobHashes;
+
+        // Interleaved so both schedulers see the same machine state
+        for (int run = 0; run < options.runs; run++) {
+            pools.push_back(runSchedulerPass(options, blockRegistry, prefabRegistry, Scheduler::THREAD_POOLS, threadCount, poolHashes));
+            jobs.push_back(runSchedulerPass(options, blockRegistry, prefabRegistry, Scheduler::JOB_SYSTEM, threadCount, jobHashes));
+        }
+
+        fmt::print("threads {:>2} | ThreadPool (2 pools x {}) {:>8.1f} ms | JobSystem ({}) {:>8.1f} ms | median of {}\n",
+            threadCount, threadCount, median(pools), threadCount, median(jobs), options.runs);
+
+        failures += compareGolden(golden, poolHashes, threadCount);
+        failures += compareGolden(golden, jobHashes, threadCount);
+    }
+    return failures;
+}
+
+int main(const int argc, char** argv)
+{
+    try {
+        const BenchOptions options = parseOptions(argc, argv);
+        const BlockRegistry blockRegistry;
+        const PrefabRegistry prefabRegistry(blockRegistry);
+
+        if (options.densityBaseline) {
+            fmt::print("Density terrain, {}x{}x{} chunks, one thread\n", options.size, options.height, options.size);
+            runDensityBaseline(options, blockRegistry, prefabRegistry);
+            return 0;
+        }
+
+        ChunkHashes golden = options.updateGolden ? ChunkHashes{} : loadGolden(options.golden);
+
+        if (options.schedulerBaseline) {
+            fmt::print("Scheduler comparison, {}x{}x{} chunks, {} terrain\n", options.size, options.height, options.size,
+                options.mode == TerrainMode::DENSITY ? "density" : "heightmap");
+            return runSchedulerBaseline(options, blockRegistry, prefabRegistry, golden) == 0 ? 0 : 1;
+        }
+
+        fmt::print("World generation, {}x{}x{} chunks, {} terrain, noise {}\n",
+            options.size, options.height, options.size,
+            options.mode == TerrainMode::DENSITY ? "density" : "heightmap",
+            BatchNoise::getBackendName(BatchNoise::detectBackend()));
+
+        int failures = 0;
+
+        for (const std::size_t threadCount : options.threads) {
+            const ChunkHashes hashes = runPass(options, blockRegistry, prefabRegistry, threadCount);
+
+            // The first pass writes the golden file, the next ones still check against it
+            if (options.updateGolden && golden.empty()) {
+                saveGolden(options.golden, hashes);
+                fmt::print("threads {:>2} | golden written to {}\n", threadCount, options.golden);
+                golden = hashes;
+                continue;
+            }
+            failures += compareGolden(golden, hashes, threadCount);
+        }
+        return failures == 0 ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 2;
+    }
+}
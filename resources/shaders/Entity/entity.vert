@@ -6,6 +6,12 @@ struct TextureSlot {
     uint _pad0, _pad1, _pad2;
 };
 
+struct Instance {
+    mat4 model;
+    uint layer;
+    uint _pad0, _pad1, _pad2;
+};
+
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec3 normals;
 layout (location = 2) in vec2 uvs;
@@ -14,19 +20,24 @@ layout (std430, binding = 0) readonly buffer TextureSlots {
     TextureSlot slots[];
 };
 
+layout (std430, binding = 1) readonly buffer Instances {
+    Instance instances[];
+};
+
 out vec2 currentUvs;
 out vec4 atlasUvBounds;
 flat out uint currentLayer;
 
-uniform mat4 ModelMatrix;
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
-uniform uint LayerId;
 
 void main()
 {
+    // Instances of a draw start at its base instance
+    Instance instance = instances[gl_BaseInstance + gl_InstanceID];
+
     // Look up texture slot from atlas
-    TextureSlot slot = slots[LayerId];
+    TextureSlot slot = slots[instance.layer];
 
     // Output
     currentUvs = uvs;
@@ -34,5 +45,5 @@ void main()
     currentLayer = slot.layer;
 
     // Position
-    gl_Position = ProjectionMatrix * ViewMatrix * ModelMatrix * vec4(pos, 1.0);
+    gl_Position = ProjectionMatrix * ViewMatrix * instance.model * vec4(pos, 1.0);
 }
\ No newline at end of file
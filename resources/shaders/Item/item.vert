@@ -6,6 +6,12 @@ struct TextureSlot {
     uint _pad0, _pad1, _pad2;
 };
 
+struct Instance {
+    mat4 model;
+    uint layer;
+    uint _pad0, _pad1, _pad2;
+};
+
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 uvs;
@@ -14,24 +20,27 @@ layout (std430, binding = 0) readonly buffer TextureSlots {
     TextureSlot slots[];
 };
 
+layout (std430, binding = 1) readonly buffer Instances {
+    Instance instances[];
+};
+
 out vec2 currentUvs;
 out vec4 atlasUvBounds;
 out vec3 fragNormal;
 flat out uint currentLayer;
 
-uniform mat4 ModelMatrix;
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
-uniform uint LayerId;
 
 void main()
 {
-    TextureSlot slot = slots[LayerId];
+    Instance instance = instances[gl_BaseInstance + gl_InstanceID];
+    TextureSlot slot = slots[instance.layer];
     currentUvs = uvs;
     atlasUvBounds = vec4(slot.u0, slot.v0, slot.u1, slot.v1);
     currentLayer = slot.layer;
 
     fragNormal = normal;
 
-    gl_Position = ProjectionMatrix * ViewMatrix * ModelMatrix * vec4(pos, 1.0);
+    gl_Position = ProjectionMatrix * ViewMatrix * instance.model * vec4(pos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,367 @@
+#include "BatchNoise.h"
+#include "SimdTarget.h"
+
+namespace {
+    // Copy of FastNoiseLite's private Gradients2D table, must stay in sync with lib/fastnoiselite
+    alignas(32) constexpr float GRADIENTS_2D[256] = {
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+        -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+    };
+
+    constexpr int PRIME_X = 501125321;
+    constexpr int PRIME_Y = 1136930381;
+    constexpr int HASH_MULTIPLIER = 0x27d4eb2d;
+
+    // Same expressions as FastNoiseLite, evaluated in float so the constants round identically
+    constexpr float SKEW_SQRT3 = static_cast<float>(1.7320508075688772935274463415059);
+    constexpr float F2 = 0.5f * (SKEW_SQRT3 - 1);
+    constexpr float SQRT3 = 1.7320508075688772935274463415059f;
+    constexpr float G2 = (3 - SQRT3) / 6;
+    constexpr float C_T = static_cast<float>(2 * (1 - 2 * G2) * (1 / G2 - 2));
+    constexpr float C_A = static_cast<float>(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+    constexpr float SCALE = 99.83685446303647f;
+
+    int fastFloor(const float f)
+    {
+        return f >= 0 ? static_cast<int>(f) : static_cast<int>(f) - 1;
+    }
+
+    float gradCoord(const int seed, const int xPrimed, const int yPrimed, const float xd, const float yd)
+    {
+        auto hash = static_cast<int>(static_cast<uint32_t>(seed ^ xPrimed ^ yPrimed) * static_cast<uint32_t>(HASH_MULTIPLIER));
+        hash ^= hash >> 15;
+        hash &= 127 << 1;
+
+        return xd * GRADIENTS_2D[hash] + yd * GRADIENTS_2D[hash | 1];
+    }
+
+    float singleSimplex(const int seed, const float frequency, float x, float y)
+    {
+        x *= frequency;
+        y *= frequency;
+
+        const float s = (x + y) * F2;
+        x += s;
+        y += s;
+
+        int i = fastFloor(x);
+        int j = fastFloor(y);
+        const float xi = x - static_cast<float>(i);
+        const float yi = y - static_cast<float>(j);
+
+        const float t = (xi + yi) * G2;
+        const float x0 = xi - t;
+        const float y0 = yi - t;
+
+        i = static_cast<int>(static_cast<uint32_t>(i) * static_cast<uint32_t>(PRIME_X));
+        j = static_cast<int>(static_cast<uint32_t>(j) * static_cast<uint32_t>(PRIME_Y));
+
+        float n0 = 0, n1 = 0, n2 = 0;
+
+        const float a = 0.5f - x0 * x0 - y0 * y0;
+        if (a > 0)
+            n0 = (a * a) * (a * a) * gradCoord(seed, i, j, x0, y0);
+
+        const float c = C_T * t + (C_A + a);
+        if (c > 0) {
+            const float x2 = x0 + (2 * G2 - 1);
+            const float y2 = y0 + (2 * G2 - 1);
+            n2 = (c * c) * (c * c) * gradCoord(seed, i + PRIME_X, j + PRIME_Y, x2, y2);
+        }
+
+        if (y0 > x0) {
+            const float x1 = x0 + G2;
+            const float y1 = y0 + (G2 - 1);
+            const float b = 0.5f - x1 * x1 - y1 * y1;
+            if (b > 0)
+                n1 = (b * b) * (b * b) * gradCoord(seed, i, j + PRIME_Y, x1, y1);
+        }
+        else {
+            const float x1 = x0 + (G2 - 1);
+            const float y1 = y0 + G2;
+            const float b = 0.5f - x1 * x1 - y1 * y1;
+            if (b > 0)
+                n1 = (b * b) * (b * b) * gradCoord(seed, i + PRIME_X, j, x1, y1);
+        }
+
+        return (n0 + n1 + n2) * SCALE;
+    }
+}
+
+BatchNoise::BatchNoise(const int _seed, const float _frequency) :
+    seed(_seed),
+    frequency(_frequency),
+    backend(detectBackend())
+{}
+
+void BatchNoise::sampleGrid2D(const int originX, const int originZ, Grid2D& out) const
+{
+    switch (this->backend) {
+        case Backend::AVX2:
+            this->sampleAvx2(originX, originZ, out);
+            break;
+        case Backend::SSE41:
+            this->sampleSse41(originX, originZ, out);
+            break;
+        default:
+            this->sampleScalar(originX, originZ, out);
+            break;
+    }
+}
+
+void BatchNoise::setBackend(const Backend _backend)
+{
+    this->backend = std::min(_backend, detectBackend());
+}
+
+BatchNoise::Backend BatchNoise::detectBackend()
+{
+    return CpuFeatures::detectSimdLevel();
+}
+
+const char* BatchNoise::getBackendName(const Backend backend)
+{
+    return CpuFeatures::getName(backend);
+}
+
+void BatchNoise::sampleScalar(const int originX, const int originZ, Grid2D& out) const
+{
+    for (int z = 0; z < GRID_SIZE; z++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            out[x + z * GRID_SIZE] = singleSimplex(
+                this->seed, this->frequency, static_cast<float>(originX + x), static_cast<float>(originZ + z)
+            );
+        }
+    }
+}
+
+#ifdef FARFIELD_SIMD_X86
+
+namespace {
+    FARFIELD_TARGET("sse4.1")
+    __m128 gradCoordSse41(const __m128i seed, const __m128i xPrimed, const __m128i yPrimed, const __m128 xd, const __m128 yd)
+    {
+        __m128i hash = _mm_xor_si128(seed, _mm_xor_si128(xPrimed, yPrimed));
+        hash = _mm_mullo_epi32(hash, _mm_set1_epi32(HASH_MULTIPLIER));
+        hash = _mm_xor_si128(hash, _mm_srai_epi32(hash, 15));
+        hash = _mm_and_si128(hash, _mm_set1_epi32(127 << 1));
+
+        alignas(16) int index[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), hash);
+
+        const __m128 xg = _mm_setr_ps(GRADIENTS_2D[index[0]], GRADIENTS_2D[index[1]], GRADIENTS_2D[index[2]], GRADIENTS_2D[index[3]]);
+        const __m128 yg = _mm_setr_ps(GRADIENTS_2D[index[0] | 1], GRADIENTS_2D[index[1] | 1], GRADIENTS_2D[index[2] | 1], GRADIENTS_2D[index[3] | 1]);
+
+        return _mm_add_ps(_mm_mul_ps(xd, xg), _mm_mul_ps(yd, yg));
+    }
+
+    // (v * v) * (v * v) * grad, zero where v <= 0
+    FARFIELD_TARGET("sse4.1")
+    __m128 attenuateSse41(const __m128 v, const __m128 grad)
+    {
+        const __m128 v2 = _mm_mul_ps(v, v);
+        const __m128 n = _mm_mul_ps(_mm_mul_ps(v2, v2), grad);
+        return _mm_and_ps(n, _mm_cmpgt_ps(v, _mm_setzero_ps()));
+    }
+
+    FARFIELD_TARGET("sse4.1")
+    __m128 singleSimplexSse41(const __m128i seed, const __m128 frequency, __m128 x, __m128 y)
+    {
+        x = _mm_mul_ps(x, frequency);
+        y = _mm_mul_ps(y, frequency);
+
+        const __m128 s = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(F2));
+        x = _mm_add_ps(x, s);
+        y = _mm_add_ps(y, s);
+
+        // Truncate, minus one for negative values (FastNoiseLite's FastFloor)
+        const __m128 zero = _mm_setzero_ps();
+        __m128i i = _mm_add_epi32(_mm_cvttps_epi32(x), _mm_castps_si128(_mm_cmplt_ps(x, zero)));
+        __m128i j = _mm_add_epi32(_mm_cvttps_epi32(y), _mm_castps_si128(_mm_cmplt_ps(y, zero)));
+        const __m128 xi = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+        const __m128 yi = _mm_sub_ps(y, _mm_cvtepi32_ps(j));
+
+        const __m128 t = _mm_mul_ps(_mm_add_ps(xi, yi), _mm_set1_ps(G2));
+        const __m128 x0 = _mm_sub_ps(xi, t);
+        const __m128 y0 = _mm_sub_ps(yi, t);
+
+        i = _mm_mullo_epi32(i, _mm_set1_epi32(PRIME_X));
+        j = _mm_mullo_epi32(j, _mm_set1_epi32(PRIME_Y));
+        const __m128i iNext = _mm_add_epi32(i, _mm_set1_epi32(PRIME_X));
+        const __m128i jNext = _mm_add_epi32(j, _mm_set1_epi32(PRIME_Y));
+
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 a = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0));
+        const __m128 n0 = attenuateSse41(a, gradCoordSse41(seed, i, j, x0, y0));
+
+        const __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(C_T), t), _mm_add_ps(_mm_set1_ps(C_A), a));
+        const __m128 x2 = _mm_add_ps(x0, _mm_set1_ps(2 * G2 - 1));
+        const __m128 y2 = _mm_add_ps(y0, _mm_set1_ps(2 * G2 - 1));
+        const __m128 n2 = attenuateSse41(c, gradCoordSse41(seed, iNext, jNext, x2, y2));
+
+        const __m128 yGreater = _mm_cmpgt_ps(y0, x0);
+        const __m128 x1 = _mm_add_ps(x0, _mm_blendv_ps(_mm_set1_ps(G2 - 1), _mm_set1_ps(G2), yGreater));
+        const __m128 y1 = _mm_add_ps(y0, _mm_blendv_ps(_mm_set1_ps(G2), _mm_set1_ps(G2 - 1), yGreater));
+        const __m128i i1 = _mm_blendv_epi8(iNext, i, _mm_castps_si128(yGreater));
+        const __m128i j1 = _mm_blendv_epi8(j, jNext, _mm_castps_si128(yGreater));
+        const __m128 b = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1));
+        const __m128 n1 = attenuateSse41(b, gradCoordSse41(seed, i1, j1, x1, y1));
+
+        return _mm_mul_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), _mm_set1_ps(SCALE));
+    }
+
+    FARFIELD_TARGET("avx2")
+    __m256 gradCoordAvx2(const __m256i seed, const __m256i xPrimed, const __m256i yPrimed, const __m256 xd, const __m256 yd)
+    {
+        __m256i hash = _mm256_xor_si256(seed, _mm256_xor_si256(xPrimed, yPrimed));
+        hash = _mm256_mullo_epi32(hash, _mm256_set1_epi32(HASH_MULTIPLIER));
+        hash = _mm256_xor_si256(hash, _mm256_srai_epi32(hash, 15));
+        hash = _mm256_and_si256(hash, _mm256_set1_epi32(127 << 1));
+
+        const __m256 xg = _mm256_i32gather_ps(GRADIENTS_2D, hash, 4);
+        const __m256 yg = _mm256_i32gather_ps(GRADIENTS_2D, _mm256_or_si256(hash, _mm256_set1_epi32(1)), 4);
+
+        return _mm256_add_ps(_mm256_mul_ps(xd, xg), _mm256_mul_ps(yd, yg));
+    }
+
+    FARFIELD_TARGET("avx2")
+    __m256 attenuateAvx2(const __m256 v, const __m256 grad)
+    {
+        const __m256 v2 = _mm256_mul_ps(v, v);
+        const __m256 n = _mm256_mul_ps(_mm256_mul_ps(v2, v2), grad);
+        return _mm256_and_ps(n, _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GT_OQ));
+    }
+
+    FARFIELD_TARGET("avx2")
+    __m256 singleSimplexAvx2(const __m256i seed, const __m256 frequency, __m256 x, __m256 y)
+    {
+        x = _mm256_mul_ps(x, frequency);
+        y = _mm256_mul_ps(y, frequency);
+
+        const __m256 s = _mm256_mul_ps(_mm256_add_ps(x, y), _mm256_set1_ps(F2));
+        x = _mm256_add_ps(x, s);
+        y = _mm256_add_ps(y, s);
+
+        const __m256 zero = _mm256_setzero_ps();
+        __m256i i = _mm256_add_epi32(_mm256_cvttps_epi32(x), _mm256_castps_si256(_mm256_cmp_ps(x, zero, _CMP_LT_OQ)));
+        __m256i j = _mm256_add_epi32(_mm256_cvttps_epi32(y), _mm256_castps_si256(_mm256_cmp_ps(y, zero, _CMP_LT_OQ)));
+        const __m256 xi = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+        const __m256 yi = _mm256_sub_ps(y, _mm256_cvtepi32_ps(j));
+
+        const __m256 t = _mm256_mul_ps(_mm256_add_ps(xi, yi), _mm256_set1_ps(G2));
+        const __m256 x0 = _mm256_sub_ps(xi, t);
+        const __m256 y0 = _mm256_sub_ps(yi, t);
+
+        i = _mm256_mullo_epi32(i, _mm256_set1_epi32(PRIME_X));
+        j = _mm256_mullo_epi32(j, _mm256_set1_epi32(PRIME_Y));
+        const __m256i iNext = _mm256_add_epi32(i, _mm256_set1_epi32(PRIME_X));
+        const __m256i jNext = _mm256_add_epi32(j, _mm256_set1_epi32(PRIME_Y));
+
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 a = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x0, x0)), _mm256_mul_ps(y0, y0));
+        const __m256 n0 = attenuateAvx2(a, gradCoordAvx2(seed, i, j, x0, y0));
+
+        const __m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(C_T), t), _mm256_add_ps(_mm256_set1_ps(C_A), a));
+        const __m256 x2 = _mm256_add_ps(x0, _mm256_set1_ps(2 * G2 - 1));
+        const __m256 y2 = _mm256_add_ps(y0, _mm256_set1_ps(2 * G2 - 1));
+        const __m256 n2 = attenuateAvx2(c, gradCoordAvx2(seed, iNext, jNext, x2, y2));
+
+        const __m256 yGreater = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+        const __m256 x1 = _mm256_add_ps(x0, _mm256_blendv_ps(_mm256_set1_ps(G2 - 1), _mm256_set1_ps(G2), yGreater));
+        const __m256 y1 = _mm256_add_ps(y0, _mm256_blendv_ps(_mm256_set1_ps(G2), _mm256_set1_ps(G2 - 1), yGreater));
+        const __m256i i1 = _mm256_blendv_epi8(iNext, i, _mm256_castps_si256(yGreater));
+        const __m256i j1 = _mm256_blendv_epi8(j, jNext, _mm256_castps_si256(yGreater));
+        const __m256 b = _mm256_sub_ps(_mm256_sub_ps(half, _mm256_mul_ps(x1, x1)), _mm256_mul_ps(y1, y1));
+        const __m256 n1 = attenuateAvx2(b, gradCoordAvx2(seed, i1, j1, x1, y1));
+
+        return _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), _mm256_set1_ps(SCALE));
+    }
+
+    FARFIELD_TARGET("sse4.1")
+    void sampleGridSse41(const int seed, const float frequency, const int originX, const int originZ, float* out)
+    {
+        const __m128i seedV = _mm_set1_epi32(seed);
+        const __m128 frequencyV = _mm_set1_ps(frequency);
+        const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+
+        for (int z = 0; z < BatchNoise::GRID_SIZE; z++) {
+            const __m128 y = _mm_set1_ps(static_cast<float>(originZ + z));
+
+            for (int x = 0; x < BatchNoise::GRID_SIZE; x += 4) {
+                const __m128 xs = _mm_add_ps(_mm_set1_ps(static_cast<float>(originX + x)), lane);
+                _mm_storeu_ps(out + x + z * BatchNoise::GRID_SIZE, singleSimplexSse41(seedV, frequencyV, xs, y));
+            }
+        }
+    }
+
+    FARFIELD_TARGET("avx2")
+    void sampleGridAvx2(const int seed, const float frequency, const int originX, const int originZ, float* out)
+    {
+        const __m256i seedV = _mm256_set1_epi32(seed);
+        const __m256 frequencyV = _mm256_set1_ps(frequency);
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        for (int z = 0; z < BatchNoise::GRID_SIZE; z++) {
+            const __m256 y = _mm256_set1_ps(static_cast<float>(originZ + z));
+
+            for (int x = 0; x < BatchNoise::GRID_SIZE; x += 8) {
+                const __m256 xs = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(originX + x), lane));
+                _mm256_storeu_ps(out + x + z * BatchNoise::GRID_SIZE, singleSimplexAvx2(seedV, frequencyV, xs, y));
+            }
+        }
+    }
+}
+
+void BatchNoise::sampleSse41(const int originX, const int originZ, Grid2D& out) const
+{
+    sampleGridSse41(this->seed, this->frequency, originX, originZ, out.data());
+}
+
+void BatchNoise::sampleAvx2(const int originX, const int originZ, Grid2D& out) const
+{
+    sampleGridAvx2(this->seed, this->frequency, originX, originZ, out.data());
+}
+
+#else
+
+void BatchNoise::sampleSse41(const int originX, const int originZ, Grid2D& out) const
+{
+    this->sampleScalar(originX, originZ, out);
+}
+
+void BatchNoise::sampleAvx2(const int originX, const int originZ, Grid2D& out) const
+{
+    this->sampleScalar(originX, originZ, out);
+}
+
+#endif
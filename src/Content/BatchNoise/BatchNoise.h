@@ -0,0 +1,45 @@
+#ifndef FARFIELD_BATCHNOISE_H
+#define FARFIELD_BATCHNOISE_H
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+#include "CpuFeatures.h"
+
+// Batched 2D OpenSimplex2 noise, evaluated a whole 16x16 grid at a time.
+// Matches FastNoiseLite::GetNoise(float, float) for the same seed and frequency (no fractal) bit for bit
+// on every backend, as long as the FastNoiseLite side is not built with FMA contraction. In that case
+// samples may differ by a few ulps (below 1e-6), while the backends here still agree with each other.
+class BatchNoise {
+    public:
+        static constexpr int GRID_SIZE = 16;
+        using Grid2D = std::array<float, GRID_SIZE * GRID_SIZE>;
+
+        using Backend = CpuFeatures::SimdLevel;
+
+        BatchNoise(int _seed, float _frequency);
+
+        // out[x + z * 16] is the noise at (originX + x, originZ + z)
+        void sampleGrid2D(int originX, int originZ, Grid2D& out) const;
+
+        // Backends the CPU doesn't support fall back to the best supported one
+        void setBackend(Backend _backend);
+        [[nodiscard]] Backend getBackend() const { return this->backend; }
+
+        [[nodiscard]] static Backend detectBackend();
+        [[nodiscard]] static const char* getBackendName(Backend backend);
+
+    private:
+        int seed;
+        float frequency;
+        Backend backend;
+
+        void sampleScalar(int originX, int originZ, Grid2D& out) const;
+        void sampleSse41(int originX, int originZ, Grid2D& out) const;
+        void sampleAvx2(int originX, int originZ, Grid2D& out) const;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef FARFIELD_BIOME_H
+#define FARFIELD_BIOME_H
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+enum class BiomeId : uint8_t
+{
+    PLAINS,
+    FOREST,
+    MEADOW,
+    ROCKY,
+
+    COUNT
+};
+
+// Climate fields, each noise in [-1, 1]
+struct Climate {
+    float temperature;
+    float humidity;
+    float continentalness;
+};
+
+struct Biome {
+    const char* name;
+    const char* surface;   // Top block
+    const char* filler;    // Blocks between the top and the underground
+    uint8_t treeChance;    // Percent of the tree candidates kept
+};
+
+inline constexpr std::array<Biome, static_cast<std::size_t>(BiomeId::COUNT)> BIOMES{{
+    {"plains", "core:grass", "core:dirt", 25},
+    {"forest", "core:grass", "core:dirt", 100},
+    {"meadow", "core:moss", "core:dirt", 0},
+    {"rocky", "core:stone", "core:cobble", 0},
+}};
+
+[[nodiscard]] inline BiomeId selectBiome(const Climate& climate)
+{
+    if (climate.continentalness > 0.6f || climate.temperature < -0.7f)
+        return BiomeId::ROCKY;
+    if (climate.humidity > 0.2f)
+        return climate.temperature > 0.f ? BiomeId::FOREST : BiomeId::MEADOW;
+    return BiomeId::PLAINS;
+}
+
+[[nodiscard]] inline const Biome& getBiome(const BiomeId id)
+{
+    return BIOMES[static_cast<std::size_t>(id)];
+}
+
+#endif
\ No newline at end of file
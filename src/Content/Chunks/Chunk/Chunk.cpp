@@ -1,7 +1,8 @@
 #include "Chunk.h"
 
-Chunk::Chunk(const ChunkPos pos) :
-    position(pos)
+Chunk::Chunk(const ChunkPos pos, const BlockRegistry& blockRegistry) :
+    position(pos),
+    blockRegistry(&blockRegistry)
 {
     this->blockBuffers[0].fill(Material());
     this->blockBuffers[1].fill(Material());
@@ -9,19 +10,28 @@ Chunk::Chunk(const ChunkPos pos) :
 
 Chunk::Chunk(Chunk&& other) noexcept :
     position(other.position),
+    blockRegistry(other.blockRegistry),
     blockBuffers{other.blockBuffers[0], other.blockBuffers[1]},
     bufferReadIndex(other.bufferReadIndex.load()),
     bufferActiveReaders(other.bufferActiveReaders.load()),
     pendingChanges(other.pendingChanges.load()),
     state(other.state.load()),
     generationID(other.generationID.load()),
-    dirty(other.dirty.load())
-{}
+    dirty(other.dirty.load()),
+    completedSteps(other.completedSteps.load()),
+    claimedSteps(other.claimedSteps.load()),
+    pendingEdits(std::move(other.pendingEdits)),
+    heightmaps(other.heightmaps)
+{
+    for (std::size_t i = 0; i < this->doneNeighbors.size(); i++)
+        this->doneNeighbors[i].store(other.doneNeighbors[i].load());
+}
 
 Chunk& Chunk::operator=(Chunk&& other) noexcept
 {
     if (this != &other) {
         position = other.position;
+        blockRegistry = other.blockRegistry;
         blockBuffers[0] = other.blockBuffers[0];
         blockBuffers[1] = other.blockBuffers[1];
         bufferReadIndex.store(other.bufferReadIndex.load());
@@ -30,6 +40,13 @@ Chunk& Chunk::operator=(Chunk&& other) noexcept
         state.store(other.state.load());
         generationID.store(other.generationID.load());
         dirty.store(other.dirty.load());
+        completedSteps.store(other.completedSteps.load());
+        claimedSteps.store(other.claimedSteps.load());
+        pendingEdits = std::move(other.pendingEdits);
+        heightmaps = other.heightmaps;
+
+        for (std::size_t i = 0; i < doneNeighbors.size(); i++)
+            doneNeighbors[i].store(other.doneNeighbors[i].load());
     }
     return *this;
 }
@@ -68,6 +85,7 @@ void Chunk::setBlock(const uint8_t x, const uint8_t y, const uint8_t z, const Ma
     const uint8_t writeIdx = getWriteIndex();
 
     this->blockBuffers[writeIdx][ChunkPos::localCoordsToIndex(x, y, z)] = mat;
+    this->updateHeightmaps(this->blockBuffers[writeIdx], {x, y, z}, {x, y, z}, mat.getBlockId());
     this->pendingChanges.store(true, std::memory_order_release);
 }
 
@@ -83,25 +101,76 @@ void Chunk::fill(const glm::ivec3 from, const glm::ivec3 to, const Material mat)
         }
     }
 
+    this->updateHeightmaps(this->blockBuffers[writeIdx], from, to, mat.getBlockId());
+
     this->pendingChanges.store(true, std::memory_order_release);
 }
 
 void Chunk::setBlockDirect(const uint8_t x, const uint8_t y, const uint8_t z, const Material mat)
 {
     this->blockBuffers[0][ChunkPos::localCoordsToIndex(x, y, z)] = mat;
+    this->updateHeightmaps(this->blockBuffers[0], {x, y, z}, {x, y, z}, mat.getBlockId());
 }
 
 void Chunk::fillDirect(const glm::ivec3 from, const glm::ivec3 to, const Material mat)
 {
+    // Rows along x are contiguous in storage
     for (int z = from.z; z <= to.z; ++z) {
         for (int y = from.y; y <= to.y; ++y) {
-            for (int x = from.x; x <= to.x; ++x) {
-                this->setBlockDirect(x, y, z, mat);
-            }
+            const auto row = this->blockBuffers[0].begin() + ChunkPos::localCoordsToIndex(from.x, y, z);
+            std::fill_n(row, to.x - from.x + 1, mat);
+        }
+    }
+
+    this->updateHeightmaps(this->blockBuffers[0], from, to, mat.getBlockId());
+}
+
+void Chunk::placeRowDirect(const uint8_t x, const uint8_t y, const uint8_t z, const uint8_t length, const Material mat)
+{
+    const int start = ChunkPos::localCoordsToIndex(x, y, z);
+    // Only air is replaced and air never counts, so heightmaps can only go up
+    const uint8_t written = this->getHeightmapMask(mat.getBlockId());
+
+    for (int i = 0; i < length; i++) {
+        Material& block = this->blockBuffers[0][start + i];
+
+        if (block.getBlockId() != 0)
+            continue;
+
+        block = mat;
+
+        for (std::size_t h = 0; h < HEIGHTMAP_COUNT; h++) {
+            uint8_t& height = this->heightmaps[h][x + i + z * SIZE];
+
+            if (written & (1u << h))
+                height = std::max(height, static_cast<uint8_t>(y + 1));
         }
     }
 }
 
+void Chunk::setColumnDirect(const uint8_t x, const uint8_t z, const std::array<Material, 16>& column)
+{
+    for (int y = 0; y < SIZE; y++)
+        this->blockBuffers[0][ChunkPos::localCoordsToIndex(x, y, z)] = column[y];
+
+    // Top down, each heightmap stops at the first block counting for it
+    constexpr uint8_t ALL_HEIGHTMAPS = (1u << HEIGHTMAP_COUNT) - 1;
+    uint8_t found = 0;
+
+    for (int y = SIZE - 1; y >= 0 && found != ALL_HEIGHTMAPS; y--) {
+        const uint8_t mask = this->getHeightmapMask(column[y].getBlockId()) & ~found;
+
+        for (std::size_t i = 0; i < HEIGHTMAP_COUNT; i++)
+            if (mask & (1u << i))
+                this->heightmaps[i][x + z * SIZE] = static_cast<uint8_t>(y + 1);
+
+        found |= mask;
+    }
+
+    for (std::size_t i = 0; i < HEIGHTMAP_COUNT; i++)
+        if (!(found & (1u << i)))
+            this->heightmaps[i][x + z * SIZE] = 0;
+}
 
 bool Chunk::swapBuffers()
 {
@@ -154,6 +223,55 @@ bool Chunk::isAir(const uint8_t x, const uint8_t y, const uint8_t z) const
     return this->blockBuffers[readIdx][blockIdx].getBlockId() == 0;
 }
 
+int Chunk::getHeight(const HeightmapType type, const uint8_t x, const uint8_t z) const
+{
+    return this->heightmaps[static_cast<std::size_t>(type)][x + z * SIZE] - 1;
+}
+
+uint8_t Chunk::getHeightmapMask(const BlockId id) const
+{
+    // Air is the most common write, it never counts
+    if (id == 0)
+        return 0;
+
+    uint8_t mask = 1u << static_cast<uint8_t>(HeightmapType::WORLD_SURFACE);
+    if (!this->blockRegistry->isTransparent(id))
+        mask |= 1u << static_cast<uint8_t>(HeightmapType::OPAQUE);
+    return mask;
+}
+
+void Chunk::updateHeightmaps(const BlockStorage& blocks, const glm::ivec3 from, const glm::ivec3 to, const BlockId id)
+{
+    const uint8_t written = this->getHeightmapMask(id);
+
+    for (std::size_t i = 0; i < HEIGHTMAP_COUNT; i++) {
+        const uint8_t bit = 1u << i;
+
+        for (int z = from.z; z <= to.z; z++) {
+            for (int x = from.x; x <= to.x; x++) {
+                uint8_t& height = this->heightmaps[i][x + z * SIZE];
+
+                if (written & bit) {
+                    height = std::max(height, static_cast<uint8_t>(to.y + 1));
+                    continue;
+                }
+
+                // Only removing the current top needs a scan, down from the written range
+                if (height <= from.y || height > to.y + 1)
+                    continue;
+
+                height = 0;
+                for (int y = from.y - 1; y >= 0; y--) {
+                    if (this->getHeightmapMask(blocks[ChunkPos::localCoordsToIndex(x, y, z)].getBlockId()) & bit) {
+                        height = static_cast<uint8_t>(y + 1);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
 
 glm::mat4 Chunk::getChunkModel() const
 {
@@ -180,6 +298,11 @@ void Chunk::setState(const ChunkState newState)
     this->state.store(newState, std::memory_order_release);
 }
 
+bool Chunk::tryAdvanceState(ChunkState expected, const ChunkState newState)
+{
+    return this->state.compare_exchange_strong(expected, newState, std::memory_order_acq_rel);
+}
+
 bool Chunk::isDirty() const
 {
     return this->dirty.load(std::memory_order_acquire);
@@ -198,4 +321,74 @@ uint64_t Chunk::getGenerationID() const
 void Chunk::bumpGenerationID()
 {
     this->generationID.fetch_add(1, std::memory_order_acq_rel);
-}
\ No newline at end of file
+}
+
+std::size_t Chunk::getCompletedSteps() const
+{
+    return this->completedSteps.load(std::memory_order_acquire);
+}
+
+void Chunk::setCompletedSteps(const std::size_t steps)
+{
+    this->completedSteps.store(static_cast<uint8_t>(steps), std::memory_order_release);
+}
+
+bool Chunk::tryClaimStep(const std::size_t step)
+{
+    auto expected = static_cast<uint8_t>(step);
+    return this->claimedSteps.compare_exchange_strong(expected, expected + 1, std::memory_order_acq_rel);
+}
+
+bool Chunk::markNeighborStepDone(const std::size_t step, const int neighborIndex, const uint32_t required)
+{
+    const uint32_t bit = 1u << neighborIndex;
+    const uint32_t previous = this->doneNeighbors[step].fetch_or(bit, std::memory_order_acq_rel);
+
+    // Only the call that sets the last missing bit completes the dependency
+    return (previous & required) != required && ((previous | bit) & required) == required;
+}
+
+void Chunk::clearNeighborSteps(const int neighborIndex)
+{
+    for (auto& mask : this->doneNeighbors)
+        mask.fetch_and(~(1u << neighborIndex), std::memory_order_acq_rel);
+}
+
+void Chunk::addPendingEdit(const PendingEdit& edit)
+{
+    std::lock_guard lock(this->pendingEditsMutex);
+    this->pendingEdits.push_back(edit);
+}
+
+void Chunk::applyPendingEdits(const uint8_t stage)
+{
+    std::vector<PendingEdit> edits;
+    {
+        std::lock_guard lock(this->pendingEditsMutex);
+
+        // Edits of later stages can already be there when a neighbor got ahead after a reload, they stay queued
+        const auto ready = std::ranges::partition(this->pendingEdits, [stage](const PendingEdit& e) { return e.stage > stage; });
+        edits.assign(ready.begin(), ready.end());
+        this->pendingEdits.erase(ready.begin(), ready.end());
+    }
+
+    // Arrival order depends on thread timing, merge in (stage, source, sequence) order instead.
+    // A reloaded neighbor spills the same edits again, duplicates are dropped
+    const auto key = [](const PendingEdit& e) { return std::tie(e.stage, e.source, e.sequence); };
+
+    std::ranges::sort(edits, [&](const PendingEdit& a, const PendingEdit& b) { return key(a) < key(b); });
+    const auto duplicates = std::ranges::unique(edits, [&](const PendingEdit& a, const PendingEdit& b) { return key(a) == key(b); });
+    edits.erase(duplicates.begin(), duplicates.end());
+
+    for (const auto& edit : edits) {
+        Material& block = this->blockBuffers[0][edit.index];
+
+        if (block.getBlockId() != 0)
+            continue;
+
+        block = edit.mat;
+
+        const auto [x, y, z] = ChunkPos::indexToLocalCoords(edit.index);
+        this->updateHeightmaps(this->blockBuffers[0], {x, y, z}, {x, y, z}, edit.mat.getBlockId());
+    }
+}
@@ -10,6 +10,9 @@
 #include <thread>
 #include <atomic>
 #include <array>
+#include <vector>
+#include <mutex>
+#include <tuple>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
@@ -21,12 +24,32 @@
 
 using BlockStorage = std::array<Material, 16*16*16>;
 
+// Per column "highest block" queries, kept up to date by every block write
+enum class HeightmapType : uint8_t
+{
+    WORLD_SURFACE, // Highest non-air block
+    OPAQUE,        // Highest non-transparent block, the ground under leaves
+
+    COUNT
+};
+
+// Block written by a neighbor's decoration, merged into the chunk when it is finalized
+struct PendingEdit {
+    ChunkPos source;
+    uint32_t sequence;
+    uint16_t index;
+    uint8_t stage;
+    Material mat;
+};
+
 class Chunk {
     public:
         static constexpr uint8_t SIZE = 16;
         static constexpr uint16_t VOLUME = SIZE * SIZE * SIZE;
+        static constexpr uint32_t ALL_NEIGHBORS = (1u << 27) - 1;
+        static constexpr std::size_t MAX_GENERATION_STEPS = 16;
 
-        explicit Chunk(ChunkPos pos);
+        explicit Chunk(ChunkPos pos, const BlockRegistry& blockRegistry);
         Chunk(const Chunk&) = delete;
         Chunk& operator=(const Chunk&) = delete;
         Chunk(Chunk&& other) noexcept;
@@ -40,11 +63,18 @@ class Chunk {
         [[nodiscard]] Material getBlock(uint8_t x, uint8_t y, uint8_t z) const;
         [[nodiscard]] bool isAir(uint8_t x, uint8_t y, uint8_t z) const;
 
+        // Local Y of the highest block of the column matching the heightmap, -1 when there is none
+        [[nodiscard]] int getHeight(HeightmapType type, uint8_t x, uint8_t z) const;
+
         void setBlock(uint8_t x, uint8_t y, uint8_t z, Material mat);
         void fill(glm::ivec3 from, glm::ivec3 to, Material mat);
 
         void setBlockDirect(uint8_t x, uint8_t y, uint8_t z, Material mat);
         void fillDirect(glm::ivec3 from, glm::ivec3 to, Material mat);
+        // Run of length blocks along +x, each only written over air
+        void placeRowDirect(uint8_t x, uint8_t y, uint8_t z, uint8_t length, Material mat);
+        // Whole column from y = 0 up, the heightmaps are taken from it instead of updated per block
+        void setColumnDirect(uint8_t x, uint8_t z, const std::array<Material, 16>& column);
 
         bool swapBuffers();
         [[nodiscard]] bool hasPendingChanges() const;
@@ -55,6 +85,7 @@ class Chunk {
 
         [[nodiscard]] ChunkState getState() const;
         void setState(ChunkState newState);
+        bool tryAdvanceState(ChunkState expected, ChunkState newState);
 
         [[nodiscard]] bool isDirty() const;
         void setDirty(bool isDirty);
@@ -62,8 +93,34 @@ class Chunk {
         [[nodiscard]] uint64_t getGenerationID() const;
         void bumpGenerationID();
 
+        // Generation progress, number of pipeline steps this chunk has completed
+        [[nodiscard]] std::size_t getCompletedSteps() const;
+        void setCompletedSteps(std::size_t steps);
+        // Only the first caller for a step gets to schedule it
+        bool tryClaimStep(std::size_t step);
+
+        // Pipeline dependencies, one bit per chunk of the 3x3x3 neighborhood (self included) that completed a step.
+        // Returns true when this call completes the bits required by the next step
+        bool markNeighborStepDone(std::size_t step, int neighborIndex, uint32_t required);
+        void clearNeighborSteps(int neighborIndex);
+
+        // Spilled generation edits, only placed over air when merged
+        void addPendingEdit(const PendingEdit& edit);
+        void applyPendingEdits(uint8_t stage);
+
+        // Convert 3D offset (-1,0,1) to neighborhood bit index (0-26)
+        static int neighborIndex(const int dx, const int dy, const int dz)
+        {
+            return (dx + 1) + (dy + 1) * 3 + (dz + 1) * 9;
+        }
+
     private:
+        static constexpr std::size_t HEIGHTMAP_COUNT = static_cast<std::size_t>(HeightmapType::COUNT);
+
+        using Heightmap = std::array<uint8_t, SIZE * SIZE>; // Local Y + 1 of the highest block, 0 when there is none
+
         ChunkPos position;
+        const BlockRegistry* blockRegistry;
 
         BlockStorage blockBuffers[2]{};
         std::atomic<uint8_t> bufferReadIndex{0};
@@ -74,6 +131,20 @@ class Chunk {
         std::atomic<ChunkState> state{ChunkState::UNLOADED};
         std::atomic<uint64_t> generationID{0};
         std::atomic<bool> dirty{false};
+        std::atomic<uint8_t> completedSteps{0};
+        std::atomic<uint8_t> claimedSteps{0};
+        std::array<std::atomic<uint32_t>, MAX_GENERATION_STEPS> doneNeighbors{};
+
+        std::vector<PendingEdit> pendingEdits;
+        std::mutex pendingEditsMutex;
+
+        // Follow the latest writes, not the buffer readers currently see
+        std::array<Heightmap, HEIGHTMAP_COUNT> heightmaps{};
+
+        // One bit per HeightmapType the block counts for
+        [[nodiscard]] uint8_t getHeightmapMask(BlockId id) const;
+        // Account for the [from, to] box being set to one block, blocks holds the written storage
+        void updateHeightmaps(const BlockStorage& blocks, glm::ivec3 from, glm::ivec3 to, BlockId id);
 
         [[nodiscard]] uint8_t getWriteIndex() const
         {
@@ -1,19 +1,23 @@
 #include "ChunkManager.h"
 
-ChunkManager::ChunkManager(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry, const Settings& _settings) :
+ChunkManager::ChunkManager(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry, const Settings& _settings, JobSystem& _jobSystem) :
     blockRegistry(_blockRegistry),
     settings(_settings),
-    terrainWorkers(std::thread::hardware_concurrency()),
-    decorationWorkers(std::thread::hardware_concurrency()),
-    terrainGenerator(_blockRegistry, _prefabRegistry)
+    jobSystem(_jobSystem),
+    terrainGenerator(_blockRegistry, _prefabRegistry, _settings.getTerrainMode())
 {
-    this->terrainWorkers.setWorker([this](const ChunkJob &job) {
-        terrainJob(job);
-    });
+    this->terrainGenerator.buildPipeline(this->pipeline);
+}
 
-    this->decorationWorkers.setWorker([this](const ChunkJob &job) {
-        decorationJob(job);
-    });
+ChunkManager::~ChunkManager()
+{
+    // Workers are shared with the whole engine, make sure none of them still runs our jobs
+    this->jobSystem.cancel(this);
+}
+
+void ChunkManager::runGenerationJob(void* context, const Job& job)
+{
+    static_cast<ChunkManager*>(context)->generationJob(job.get<ChunkJob>());
 }
 
 std::shared_lock<std::shared_mutex> ChunkManager::acquireReadLock() const
@@ -28,104 +32,93 @@ void ChunkManager::requestChunk(const ChunkPos& pos)
     if (chunks.contains(pos))
         return;
 
-    auto [it, inserted] = this->chunks.try_emplace(pos, std::make_unique<Chunk>(pos));
+    auto [it, inserted] = this->chunks.try_emplace(pos, std::make_unique<Chunk>(pos, this->blockRegistry));
     Chunk& chunk = *it->second;
 
     chunk.bumpGenerationID();
-    chunk.setState(ChunkState::TERRAIN_PENDING);
-
-    this->terrainWorkers.enqueue({pos, static_cast<float>(pos.y), chunk.getGenerationID()});
-}
+    chunk.setState(ChunkState::GENERATING);
+    this->terrainGenerator.retainChunk(pos);
 
-void ChunkManager::terrainJob(const ChunkJob& job)
-{
-    Chunk* chunk = getChunk(job.pos.x, job.pos.y, job.pos.z);
+    if (pos.y > this->highestChunkY.load(std::memory_order_relaxed))
+        this->highestChunkY.store(pos.y, std::memory_order_relaxed);
 
-    if (!chunk || chunk->getGenerationID() != job.generationID)
-        return;
-
-    chunk->setState(ChunkState::TERRAIN_GENERATING);
-    this->terrainGenerator.generate(*chunk);
-    chunk->setState(ChunkState::TERRAIN_DONE);
-
-    // Queue neighbors for decoration
+    // Seed dependencies with the steps neighbors already completed (below the world counts as done)
     for (int dy = -1; dy <= 1; dy++) {
         for (int dz = -1; dz <= 1; dz++) {
             for (int dx = -1; dx <= 1; dx++) {
-                this->tryQueueDecoration({job.pos.x + dx, job.pos.y + dy, job.pos.z + dz});
+                const ChunkPos neighborPos{pos.x + dx, pos.y + dy, pos.z + dz};
+                const auto neighbor = this->chunks.find(neighborPos);
+
+                std::size_t completed = 0;
+                if (neighborPos.y < 0)
+                    completed = this->pipeline.getStepCount();
+                else if (neighbor != this->chunks.end())
+                    completed = neighbor->second->getCompletedSteps();
+
+                for (std::size_t step = 0; step < completed; step++)
+                    chunk.markNeighborStepDone(step, Chunk::neighborIndex(dx, dy, dz), Chunk::ALL_NEIGHBORS);
             }
         }
     }
+
+    this->queueStep(chunk, 0);
 }
 
-void ChunkManager::decorationJob(const ChunkJob& job)
+void ChunkManager::generationJob(const ChunkJob& job)
 {
     Chunk* chunk = this->getChunk(job.pos.x, job.pos.y, job.pos.z);
 
     if (!chunk || chunk->getGenerationID() != job.generationID)
         return;
 
-    if (!tryAcquireDecorationLock(job.pos)) {
-        chunk->setState(ChunkState::TERRAIN_DONE);
-        tryQueueDecoration(job.pos);
-        return;
-    }
-
-    chunk->setState(ChunkState::DECOR_GENERATING);
-
-    NeighborAccess neighbors(job.pos, [this](const ChunkPos& p) {
+    this->pipeline.runStep(job.step, *chunk, [this](const ChunkPos& p) {
         return this->getChunk(p.x, p.y, p.z);
     });
 
-    if (!neighbors.allNeighborsReady()) {
-        chunk->setState(ChunkState::TERRAIN_DONE);
-        releaseDecorationLock(job.pos);
+    const std::size_t next = job.step + 1;
+    chunk->setCompletedSteps(next);
+
+    if (next == this->pipeline.getStepCount()) {
+        this->finalizeChunk(*chunk);
         return;
     }
 
-    this->terrainGenerator.decorate(*chunk, neighbors);
-    chunk->setState(ChunkState::DECOR_DONE);
+    // Resolve the dependency this chunk represents for each neighbor, the last one queues their next step
+    const uint32_t required = this->pipeline.getStep(next).dependencies;
 
-    releaseDecorationLock(job.pos);
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                Chunk* neighbor = this->getChunk(job.pos.x + dx, job.pos.y + dy, job.pos.z + dz);
 
-    chunk->finalizeGeneration();
+                if (neighbor && neighbor->markNeighborStepDone(job.step, Chunk::neighborIndex(-dx, -dy, -dz), required))
+                    this->queueStep(*neighbor, next);
+            }
+        }
+    }
 }
 
-void ChunkManager::tryQueueDecoration(const ChunkPos& pos)
+void ChunkManager::queueStep(Chunk& chunk, const std::size_t step)
 {
-    Chunk* chunk = this->getChunk(pos.x, pos.y, pos.z);
-
-    if (!chunk)
-        return;
-    if (chunk->getState() != ChunkState::TERRAIN_DONE)
+    // Dependencies can complete again after a neighbor reload, only the first completion queues the step
+    if (!chunk.tryClaimStep(step))
         return;
 
-    if (this->canDecorate(pos)) {
-        chunk->setState(ChunkState::DECOR_PENDING);
-        this->decorationWorkers.enqueue({pos, static_cast<float>(pos.y), chunk->getGenerationID()});
-    }
+    const ChunkPos pos = chunk.getPosition();
+
+    this->jobSystem.submit(this->pipeline.getStepPriority(step), Job::make(
+        &ChunkManager::runGenerationJob, this, this->getJobDistance(pos),
+        ChunkJob{pos, chunk.getGenerationID(), static_cast<uint8_t>(step)}
+    ));
 }
 
-bool ChunkManager::canDecorate(const ChunkPos& pos)
+void ChunkManager::finalizeChunk(Chunk& chunk)
 {
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dz = -1; dz <= 1; dz++) {
-            for (int dx = -1; dx <= 1; dx++) {
-                const int neighborY = pos.y + dy;
-                const Chunk* neighbor = this->getChunk(pos.x + dx, neighborY, pos.z + dz);
-
-                if (!neighbor) {
-                    if (neighborY >= 0)
-                        return false;
-                    continue;
-                }
+    chunk.finalizeGeneration();
+    chunk.setState(ChunkState::GENERATED);
 
-                if (!hasTerrainComplete(neighbor->getState()))
-                    return false;
-            }
-        }
-    }
-    return true;
+    // Meshed neighbors were built against this chunk's unfinished blocks
+    this->rebuildNeighbors(chunk.getPosition());
 }
 
 Chunk* ChunkManager::getChunk(const int cx, const int cy, const int cz)
@@ -148,11 +141,29 @@ void ChunkManager::rebuildNeighbors(const ChunkPos& pos)
 
         if (n->getState() == ChunkState::READY)
             n->setDirty(true);
-        else if (n->getState() >= ChunkState::DECOR_DONE)
-            n->setState(ChunkState::DECOR_DONE);
+        else if (n->getState() >= ChunkState::GENERATED)
+            n->setState(ChunkState::GENERATED);
     }
 }
 
+int ChunkManager::getHeight(const HeightmapType type, const int wx, const int wz)
+{
+    const auto [cx, cy, cz] = ChunkPos::fromWorld(wx, 0, wz);
+    const auto [x, y, z] = BlockPos::fromWorld(wx, 0, wz);
+
+    // One heightmap read per chunk of the column, from the top
+    for (int chunkY = this->highestChunkY.load(std::memory_order_relaxed); chunkY >= 0; chunkY--) {
+        const Chunk* chunk = this->getChunk(cx, chunkY, cz);
+
+        if (!chunk || !isFullyGenerated(chunk->getState()))
+            continue;
+
+        if (const int height = chunk->getHeight(type, x, z); height >= 0)
+            return chunkY * Chunk::SIZE + height;
+    }
+    return -1;
+}
+
 void ChunkManager::updateStreaming(const glm::vec3& playerPos)
 {
     const auto& viewDistance = this->settings.getViewDistance();
@@ -161,6 +172,14 @@ void ChunkManager::updateStreaming(const glm::vec3& playerPos)
     const auto [playerX, playerY, playerZ] = ChunkPos::fromWorld(playerPos);
     std::unordered_set<ChunkPos, ChunkPosHash> wanted;
 
+    // Track player chunk, the queues are re-keyed as soon as it changes
+    bool playerMoved;
+    {
+        std::lock_guard lock(this->playerChunkMutex);
+        playerMoved = this->playerChunk != ChunkPos{playerX, playerY, playerZ};
+        this->playerChunk = {playerX, playerY, playerZ};
+    }
+
     wanted.reserve((2 * viewDistance + 1) * (2 * viewDistance + 1) * (2 * viewDistance + 1));
 
     for (int z = -viewDistance; z <= viewDistance; ++z) {
@@ -199,13 +218,62 @@ void ChunkManager::updateStreaming(const glm::vec3& playerPos)
                 std::abs(dz) > unloadDistance)
             {
                 chunk.bumpGenerationID();
+                this->clearDependencies(chunk.getPosition());
+                this->terrainGenerator.releaseChunk(chunk.getPosition());
                 it = chunks.erase(it);
             }
             else
                 ++it;
         }
+
+        // Re-prioritize queued jobs and drop the stale ones
+        if (playerMoved || ++this->ticksSinceReprioritize >= REPRIORITIZE_INTERVAL) {
+            for (const JobPriority priority : this->pipeline.getPriorities())
+                this->reprioritizeJobs(priority, this);
+            this->ticksSinceReprioritize = 0;
+        }
     }
+}
+
+float ChunkManager::getJobDistance(const ChunkPos& pos) const
+{
+    std::unique_lock lock(this->playerChunkMutex);
+    const auto [px, py, pz] = this->playerChunk;
+    lock.unlock();
+
+    const glm::vec3 delta(pos.x - px, pos.y - py, pos.z - pz);
+
+    return glm::length(delta) * Chunk::SIZE;
+}
+
+float ChunkManager::getVisibleJobDistance(const ChunkPos& pos) const
+{
+    const float distance = this->getJobDistance(pos);
+    const glm::vec3 min(pos.x * Chunk::SIZE, pos.y * Chunk::SIZE, pos.z * Chunk::SIZE);
+    const glm::vec3 max = min + glm::vec3(Chunk::SIZE);
+
+    if (this->frustum.isBoxVisible(min, max))
+        return distance;
+
+    // Chunks behind the camera are still needed, just after the visible ones around them
+    return distance + static_cast<float>(this->settings.getViewDistance() * Chunk::SIZE);
+}
+
+void ChunkManager::reprioritizeJobs(const JobPriority priority, const void* owner) const
+{
+    this->jobSystem.reprioritize(priority, [this, owner](Job& job) {
+        if (job.context != owner)
+            return true;
 
+        const auto data = job.get<ChunkJob>();
+        const auto it = this->chunks.find(data.pos);
+
+        if (it == this->chunks.end() || it->second->getGenerationID() != data.generationID)
+            return false;
+
+        job.distance = this->getVisibleJobDistance(data.pos);
+        return true;
+    });
 }
 
 std::vector<Chunk *> ChunkManager::getRenderableChunks()
@@ -234,6 +302,11 @@ void ChunkManager::updateFrustum(const glm::mat4& vpMatrix)
     this->frustum.update(vpMatrix);
 }
 
+const Frustum& ChunkManager::getFrustum() const
+{
+    return this->frustum;
+}
+
 bool ChunkManager::isAreaReady(const ChunkPos center, const int radius)
 {
     const int minX = center.x - radius;
@@ -272,42 +345,27 @@ ChunkNeighbors ChunkManager::getNeighbors(const ChunkPos& cp)
     };
 }
 
-bool ChunkManager::tryAcquireDecorationLock(const ChunkPos& pos)
+void ChunkManager::clearDependencies(const ChunkPos& pos)
 {
-    std::lock_guard lock(this->decorationLockMutex);
-
-    // Check if any chunk in 3x3x3 region is already locked
+    // Unloaded chunk no longer satisfies its neighbors' dependencies, a reload sets them again
     for (int dy = -1; dy <= 1; dy++) {
         for (int dz = -1; dz <= 1; dz++) {
             for (int dx = -1; dx <= 1; dx++) {
-                ChunkPos check = {pos.x + dx, pos.y + dy, pos.z + dz};
-                if (this->decorationLocks.contains(check)) {
-                    return false;  // Conflict with another decoration job
-                }
-            }
-        }
-    }
+                const auto neighbor = this->chunks.find({pos.x + dx, pos.y + dy, pos.z + dz});
 
-    // Lock all chunks in region
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dz = -1; dz <= 1; dz++) {
-            for (int dx = -1; dx <= 1; dx++) {
-                decorationLocks.insert({pos.x + dx, pos.y + dy, pos.z + dz});
+                if (neighbor != this->chunks.end())
+                    neighbor->second->clearNeighborSteps(Chunk::neighborIndex(-dx, -dy, -dz));
             }
         }
     }
-    return true;
 }
 
-void ChunkManager::releaseDecorationLock(const ChunkPos& pos)
+const GenerationPipeline& ChunkManager::getPipeline() const
 {
-    std::lock_guard lock(this->decorationLockMutex);
+    return this->pipeline;
+}
 
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dz = -1; dz <= 1; dz++) {
-            for (int dx = -1; dx <= 1; dx++) {
-                this->decorationLocks.erase({pos.x + dx, pos.y + dy, pos.z + dz});
-            }
-        }
-    }
+TerrainGenerator& ChunkManager::getTerrainGenerator()
+{
+    return this->terrainGenerator;
 }
\ No newline at end of file
@@ -15,8 +15,9 @@
 #include <glm/glm.hpp>
 
 #include "TerrainGenerator.h"
+#include "GenerationPipeline.h"
 #include "PrefabRegistry.h"
-#include "ThreadPool.h"
+#include "JobSystem.h"
 #include "ChunkPos.h"
 #include "Chunk.h"
 #include "ChunkNeighbors.h"
@@ -25,19 +26,17 @@
 
 using ChunkMap = std::unordered_map<ChunkPos, std::unique_ptr<Chunk>, ChunkPosHash>;
 
+// Payload of every chunk job submitted to the JobSystem
 struct ChunkJob {
     ChunkPos pos;
-    float distance;
     uint64_t generationID;
-
-    bool operator<(const ChunkJob& other) const {
-        return distance > other.distance;
-    }
+    uint8_t step = 0; // Generation pipeline step, unused by meshing
 };
 
 class ChunkManager {
     public:
-        explicit ChunkManager(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry, const Settings& _settings);
+        explicit ChunkManager(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry, const Settings& _settings, JobSystem& _jobSystem);
+        ~ChunkManager();
 
         [[nodiscard]] std::shared_lock<std::shared_mutex> acquireReadLock() const;
         [[nodiscard]] ChunkMap& getChunks();
@@ -45,42 +44,60 @@ class ChunkManager {
 
         bool isAreaReady(ChunkPos center, int radius);
         [[nodiscard]] Chunk* getChunk(int cx, int cy, int cz);
-        bool canDecorate(const ChunkPos& pos);
 
         [[nodiscard]] ChunkNeighbors getNeighbors(const ChunkPos &cp);
         void rebuildNeighbors(const ChunkPos& pos);
 
+        // World Y of the highest block of a column among the generated chunks, -1 when there is none
+        [[nodiscard]] int getHeight(HeightmapType type, int wx, int wz);
+
         void updateStreaming(const glm::vec3& playerPos);
         void updateFrustum(const glm::mat4& vpMatrix);
+        [[nodiscard]] const Frustum& getFrustum() const;
         void requestChunk(const ChunkPos& pos);
 
+        // Job priority (lower runs first) from the last known player chunk
+        [[nodiscard]] float getJobDistance(const ChunkPos& pos) const;
+        // Same as getJobDistance, but pushes chunks outside the camera frustum back (main thread only)
+        [[nodiscard]] float getVisibleJobDistance(const ChunkPos& pos) const;
+        // Re-key the ChunkJobs owner submitted to a class and drop the ones targeting unloaded chunks (chunks lock must be held).
+        // Classes are shared engine-wide, jobs of other contexts are left alone
+        void reprioritizeJobs(JobPriority priority, const void* owner) const;
+
+        // Stage list and per-step timings of world generation
+        [[nodiscard]] const GenerationPipeline& getPipeline() const;
+        [[nodiscard]] TerrainGenerator& getTerrainGenerator();
+
     private:
+        // Ticks between two re-prioritizations of the queued jobs when the player stays in the same chunk
+        static constexpr int REPRIORITIZE_INTERVAL = 15;
+
         const BlockRegistry& blockRegistry;
         const Settings& settings;
 
         std::unordered_map<ChunkPos, std::unique_ptr<Chunk>, ChunkPosHash> chunks;
         mutable std::shared_mutex chunksMutex;
+        std::atomic<int> highestChunkY{0}; // Upper bound for column scans
 
-        ThreadPool<ChunkJob> terrainWorkers;
-        ThreadPool<ChunkJob> decorationWorkers;
+        JobSystem& jobSystem;
 
         Frustum frustum{};
         TerrainGenerator terrainGenerator;
+        GenerationPipeline pipeline;
 
-        // Decoration locking mechanism to prevent concurrent writes to the same chunks
-        std::unordered_set<ChunkPos, ChunkPosHash> decorationLocks;
-        std::mutex decorationLockMutex;
+        // Player tracking used to order the job queues
+        ChunkPos playerChunk{0, 0, 0};
+        mutable std::mutex playerChunkMutex;
+        int ticksSinceReprioritize = 0;
 
         // Job handlers
-        void terrainJob(const ChunkJob& job);
-        void decorationJob(const ChunkJob& job);
-
-        // Check and queue chunks ready for decoration
-        void tryQueueDecoration(const ChunkPos& pos);
+        static void runGenerationJob(void* context, const Job& job);
+        void generationJob(const ChunkJob& job);
 
-        // Decoration lock management
-        bool tryAcquireDecorationLock(const ChunkPos& pos);
-        void releaseDecorationLock(const ChunkPos& pos);
+        // Pipeline dependencies
+        void queueStep(Chunk& chunk, std::size_t step);
+        void finalizeChunk(Chunk& chunk);
+        void clearDependencies(const ChunkPos& pos);
 };
 
 #endif
\ No newline at end of file
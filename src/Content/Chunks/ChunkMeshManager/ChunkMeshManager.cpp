@@ -3,12 +3,17 @@
 
 ChunkMeshManager::ChunkMeshManager(World& _world) :
     world(_world),
-    workers(std::thread::hardware_concurrency()
-)
+    jobSystem(_world.getJobSystem())
+{}
+
+ChunkMeshManager::~ChunkMeshManager()
+{
+    this->jobSystem.cancel(this);
+}
+
+void ChunkMeshManager::runMeshJob(void* context, const Job& job)
 {
-    this->workers.setWorker([this](const ChunkJob &job) {
-        this->buildMeshJob(job);
-    });
+    static_cast<ChunkMeshManager*>(context)->buildMeshJob(job.get<ChunkJob>());
 }
 
 void ChunkMeshManager::requestRebuild(Chunk& chunk, const float distance)
@@ -18,18 +23,17 @@ void ChunkMeshManager::requestRebuild(Chunk& chunk, const float distance)
 
     const ChunkJob job{
         chunk.getPosition(),
-        distance,
         chunk.getGenerationID()
     };
 
-    this->workers.enqueue(job);
+    this->jobSystem.submit(JobPriority::MESH_EDIT, Job::make(&ChunkMeshManager::runMeshJob, this, distance, job));
 }
 
 void ChunkMeshManager::scheduleMeshing(const glm::vec3& playerPos)
 {
     auto lock = world.getChunkManager().acquireReadLock();
     for (auto&[pos, chunk] : world.getChunkManager().getChunks()) {
-        const bool needsFirstMesh = chunk->getState() == ChunkState::DECOR_DONE;
+        const bool needsFirstMesh = chunk->getState() == ChunkState::GENERATED;
         const bool needsRemesh = chunk->getState() == ChunkState::READY && chunk->isDirty();
 
         if (!needsFirstMesh && !needsRemesh)
@@ -41,17 +45,26 @@ void ChunkMeshManager::scheduleMeshing(const glm::vec3& playerPos)
         chunk->bumpGenerationID();
         chunk->setDirty(false);
 
-        const auto center = glm::vec3(
-            pos.x * Chunk::SIZE + Chunk::SIZE / 2.0f,
-            pos.y * Chunk::SIZE + Chunk::SIZE / 2.0f,
-            pos.z * Chunk::SIZE + Chunk::SIZE / 2.0f
+        // Remeshes come from edits around the player, they jump ahead of first meshes
+        this->jobSystem.submit(
+            needsRemesh ? JobPriority::MESH_EDIT : JobPriority::MESH,
+            Job::make(
+                &ChunkMeshManager::runMeshJob,
+                this,
+                world.getChunkManager().getVisibleJobDistance(pos),
+                ChunkJob{pos, chunk->getGenerationID()}
+            )
         );
+    }
+
+    // Re-prioritize queued meshes and drop the stale ones
+    const ChunkPos playerChunk = ChunkPos::fromWorld(playerPos);
 
-        workers.enqueue({
-            pos,
-            glm::distance(playerPos, center),
-            chunk->getGenerationID()
-        });
+    if (playerChunk != this->lastPlayerChunk || ++this->ticksSinceReprioritize >= REPRIORITIZE_INTERVAL) {
+        world.getChunkManager().reprioritizeJobs(JobPriority::MESH_EDIT, this);
+        world.getChunkManager().reprioritizeJobs(JobPriority::MESH, this);
+        this->lastPlayerChunk = playerChunk;
+        this->ticksSinceReprioritize = 0;
     }
 }
 
@@ -12,7 +12,7 @@ class World; // Forward declaration
 #include "ChunkNeighbors.h"
 #include "ChunkManager.h"
 #include "ChunkMesh.h"
-#include "ThreadPool.h"
+#include "JobSystem.h"
 #include "Utils.h"
 
 
@@ -24,6 +24,7 @@ struct NeighborData {
 class ChunkMeshManager {
     public:
         explicit ChunkMeshManager(World& _world);
+        ~ChunkMeshManager();
 
         void update();
         void requestRebuild(Chunk& chunk, float distance);
@@ -33,6 +34,7 @@ class ChunkMeshManager {
 
     private:
         static constexpr int MAX_UPLOADS_PER_FRAME = 4;
+        static constexpr int REPRIORITIZE_INTERVAL = 15;
 
         static void buildFaceMesh(MeshData& mesh, const glm::ivec3& pos, MaterialFace face, uint16_t texId, BlockRotation rotation);
         static std::string getTextureFromRotation(const BlockMeta& meta, MaterialFace face, BlockRotation rotation);
@@ -40,12 +42,16 @@ class ChunkMeshManager {
         static MaterialFace remapFaceForRotation(MaterialFace face, BlockRotation rotation);
         static MaterialFace remapFaceForAxisRotation(MaterialFace face, BlockRotation rotation);
 
+        static void runMeshJob(void* context, const Job& job);
         void buildMeshJob(const ChunkJob& job);
         bool isTransparentAtSnapshot(BlockId blockId) const;
         bool isAirAtSnapshot(const BlockStorage& blockData, const NeighborData neighbors[6], int x, int y, int z) const;
 
         World& world;
-        ThreadPool<ChunkJob> workers;
+        JobSystem& jobSystem;
+
+        ChunkPos lastPlayerChunk{0, 0, 0};
+        int ticksSinceReprioritize = 0;
 
         std::unordered_map<ChunkPos, ChunkMesh, ChunkPosHash> meshes;
 
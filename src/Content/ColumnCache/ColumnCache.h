@@ -0,0 +1,53 @@
+#ifndef FARFIELD_COLUMNCACHE_H
+#define FARFIELD_COLUMNCACHE_H
+
+#pragma once
+
+#include <array>
+#include <functional>
+
+#include "GenerationCache.h"
+#include "Biome.h"
+
+struct ColumnPos {
+    int x, z;
+
+    bool operator==(const ColumnPos& other) const
+    {
+        return x == other.x && z == other.z;
+    }
+};
+
+struct ColumnPosHash {
+    std::size_t operator()(const ColumnPos& p) const noexcept {
+        const std::size_t h1 = std::hash<int>{}(p.x);
+        const std::size_t h2 = std::hash<int>{}(p.z);
+        return h1 ^ (h2 << 1);
+    }
+};
+
+// 2D values shared by every chunk stacked on the same (cx, cz) column
+struct ColumnData {
+    static constexpr int SIZE = 16;
+
+    std::array<int, SIZE * SIZE> heights{};
+    int minHeight = 0;
+    int maxHeight = 0;
+
+    // Per block column, from the climate interpolated between the coarse samples
+    std::array<BiomeId, SIZE * SIZE> biomes{};
+
+    [[nodiscard]] int getHeight(const int lx, const int lz) const
+    {
+        return this->heights[lx + lz * SIZE];
+    }
+
+    [[nodiscard]] BiomeId getBiome(const int lx, const int lz) const
+    {
+        return this->biomes[lx + lz * SIZE];
+    }
+};
+
+using ColumnCache = GenerationCache<ColumnPos, ColumnData, ColumnPosHash>;
+
+#endif
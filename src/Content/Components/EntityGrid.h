@@ -0,0 +1,10 @@
+#ifndef FARFIELD_ENTITYGRID_H
+#define FARFIELD_ENTITYGRID_H
+
+namespace ECS {
+    // Never added to an entity, stands for World's entity grid in system Access declarations:
+    // EntityGrid for the system rebuilding it, const EntityGrid for the ones querying it
+    struct EntityGrid {};
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef FARFIELD_TICKLOD_H
+#define FARFIELD_TICKLOD_H
+
+#include <cstdint>
+
+namespace ECS
+{
+    // Simulation level of detail, set every tick by the TickLodSystem.
+    // Entities without it run every tick, systems opting in skip the entity when steps is 0
+    // and catch up on steps ticks otherwise
+    struct TickLod
+    {
+        static constexpr std::uint8_t MAX_LEVEL = 3;
+        static constexpr std::uint8_t FROZEN = 0xFF; // Outside loaded chunks, time doesn't pass
+
+        std::uint8_t level = 0;   // Runs every 2^level ticks
+        std::uint8_t pending = 0; // Ticks elapsed since the last run
+        std::uint8_t steps = 1;   // Ticks to simulate on this one
+    };
+
+    inline std::uint8_t getTickSteps(const TickLod* lod)
+    {
+        return lod ? lod->steps : 1;
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef FARFIELD_GENERATIONCACHE_H
+#define FARFIELD_GENERATIONCACHE_H
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+
+// Values computed once per key and shared between generation jobs, kept while the key is retained
+template<typename Key, typename Value, typename Hash>
+class GenerationCache {
+    public:
+        using Generator = std::function<void(const Key&, Value&)>;
+
+        explicit GenerationCache(Generator _generator) :
+            generator(std::move(_generator))
+        {}
+
+        void retain(const Key& key)
+        {
+            std::lock_guard lock(this->mutex);
+
+            auto& entry = this->entries[key];
+            if (!entry)
+                entry = std::make_shared<Entry>();
+
+            entry->references++;
+        }
+
+        void release(const Key& key)
+        {
+            std::lock_guard lock(this->mutex);
+
+            const auto it = this->entries.find(key);
+            if (it == this->entries.end())
+                return;
+
+            // Workers still generating from the value keep their own reference to it
+            if (--it->second->references == 0)
+                this->entries.erase(it);
+        }
+
+        // Computed once per key, concurrent callers wait for the first one.
+        // Keys that are not retained are computed but not stored
+        [[nodiscard]] std::shared_ptr<const Value> get(const Key& key) const
+        {
+            std::shared_ptr<Entry> entry;
+            {
+                std::lock_guard lock(this->mutex);
+
+                if (const auto it = this->entries.find(key); it != this->entries.end())
+                    entry = it->second;
+            }
+
+            if (!entry)
+                entry = std::make_shared<Entry>();
+
+            std::call_once(entry->computed, [&] { this->generator(key, entry->value); });
+
+            return {entry, &entry->value};
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            std::lock_guard lock(this->mutex);
+            return this->entries.size();
+        }
+
+    private:
+        struct Entry {
+            std::once_flag computed;
+            Value value;
+            uint32_t references = 0;
+        };
+
+        Generator generator;
+
+        std::unordered_map<Key, std::shared_ptr<Entry>, Hash> entries;
+        mutable std::mutex mutex;
+};
+
+#endif
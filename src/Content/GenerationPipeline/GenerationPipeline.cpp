@@ -0,0 +1,136 @@
+#include "GenerationPipeline.h"
+
+void StepMetrics::record(const uint64_t nanoseconds)
+{
+    this->runCount.fetch_add(1, std::memory_order_relaxed);
+    this->totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    this->buckets[getBucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t previous = this->maxNanoseconds.load(std::memory_order_relaxed);
+    while (previous < nanoseconds && !this->maxNanoseconds.compare_exchange_weak(previous, nanoseconds, std::memory_order_relaxed)) {}
+}
+
+std::size_t StepMetrics::getBucket(const uint64_t nanoseconds)
+{
+    if (nanoseconds < BUCKETS_PER_OCTAVE)
+        return nanoseconds;
+
+    // Octave from the highest set bit, sub-bucket from the two bits below it
+    const int octave = std::bit_width(nanoseconds) - 1;
+    const uint64_t sub = (nanoseconds >> (octave - 2)) & (BUCKETS_PER_OCTAVE - 1);
+    return BUCKETS_PER_OCTAVE + (octave - 2) * BUCKETS_PER_OCTAVE + sub;
+}
+
+uint64_t StepMetrics::getBucketMidpoint(const std::size_t bucket)
+{
+    if (bucket < BUCKETS_PER_OCTAVE)
+        return bucket;
+
+    const std::size_t octave = (bucket - BUCKETS_PER_OCTAVE) / BUCKETS_PER_OCTAVE + 2;
+    const uint64_t sub = (bucket - BUCKETS_PER_OCTAVE) % BUCKETS_PER_OCTAVE;
+    const uint64_t width = uint64_t{1} << (octave - 2);
+    return (BUCKETS_PER_OCTAVE + sub) * width + width / 2;
+}
+
+double StepMetrics::getPercentileMs(const double p) const
+{
+    const uint64_t count = this->runCount.load(std::memory_order_relaxed);
+
+    if (count == 0)
+        return 0.0;
+
+    // Rank of the wanted run, 1-based
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count))));
+    uint64_t seen = 0;
+
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += this->buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return static_cast<double>(std::min(getBucketMidpoint(i), this->maxNanoseconds.load(std::memory_order_relaxed))) / 1e6;
+    }
+    return this->getMaxMs();
+}
+
+double StepMetrics::getAverageMs() const
+{
+    const uint64_t count = this->runCount.load(std::memory_order_relaxed);
+
+    if (count == 0)
+        return 0.0;
+    return static_cast<double>(this->totalNanoseconds.load(std::memory_order_relaxed)) / static_cast<double>(count) / 1e6;
+}
+
+double StepMetrics::getMaxMs() const
+{
+    return static_cast<double>(this->maxNanoseconds.load(std::memory_order_relaxed)) / 1e6;
+}
+
+GenerationPipeline& GenerationPipeline::addStage(GenerationStage stage)
+{
+    if (stage.readRadius < 0 || stage.readRadius > 1 || stage.writeRadius < 0 || stage.writeRadius > 1)
+        throw std::invalid_argument("[GenerationPipeline::addStage] Stage radius must be 0 or 1 : " + stage.name);
+
+    if (this->stages.empty() && stage.readRadius > 0)
+        throw std::invalid_argument("[GenerationPipeline::addStage] First stage has no neighbors to read : " + stage.name);
+
+    const std::size_t index = this->stages.size();
+    this->stages.push_back(std::move(stage));
+
+    const auto& added = this->stages.back();
+
+    if (std::ranges::find(this->priorities, added.priority) == this->priorities.end())
+        this->priorities.push_back(added.priority);
+    this->addStep(index, false, added.readRadius, added.writeRadius);
+
+    // Spilled blocks are merged once every chunk that could write them has run the stage
+    if (added.writeRadius > 0)
+        this->addStep(index, true, 0, 0);
+
+    return *this;
+}
+
+void GenerationPipeline::addStep(const std::size_t stage, const bool merge, const int readRadius, const int writeRadius)
+{
+    if (this->steps.size() >= Chunk::MAX_GENERATION_STEPS)
+        throw std::runtime_error("[GenerationPipeline::addStep] Too many generation steps");
+
+    const GenerationStage& owner = this->stages[stage];
+
+    // Wait for the neighbors this step touches, and for the ones that read this chunk during the
+    // previous step, so a chunk never changes while a neighbor is reading it
+    int radius = merge ? std::max(owner.readRadius, owner.writeRadius) : std::max(readRadius, writeRadius);
+    if (!this->steps.empty())
+        radius = std::max(radius, this->steps.back().readRadius);
+
+    this->steps.push_back({stage, merge, readRadius, writeRadius, radiusMask(radius)});
+}
+
+uint32_t GenerationPipeline::radiusMask(const int radius)
+{
+    return radius == 0 ? 1u << Chunk::neighborIndex(0, 0, 0) : Chunk::ALL_NEIGHBORS;
+}
+
+std::string GenerationPipeline::getStepName(const std::size_t index) const
+{
+    const GenerationStep& step = this->steps[index];
+    const std::string& name = this->stages[step.stage].name;
+
+    return step.merge ? name + " (merge)" : name;
+}
+
+void GenerationPipeline::runStep(const std::size_t stepIndex, Chunk& chunk, const ChunkGetter& getChunk)
+{
+    const GenerationStep& step = this->steps[stepIndex];
+    const auto start = std::chrono::steady_clock::now();
+
+    if (step.merge)
+        chunk.applyPendingEdits(static_cast<uint8_t>(step.stage));
+    else {
+        NeighborAccess neighbors(chunk.getPosition(), getChunk, static_cast<uint8_t>(step.stage), step.readRadius, step.writeRadius);
+        this->stages[step.stage].run(chunk, neighbors);
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    this->metrics[stepIndex].record(static_cast<uint64_t>(elapsed.count()));
+}
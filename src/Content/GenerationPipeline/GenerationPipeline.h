@@ -0,0 +1,90 @@
+#ifndef FARFIELD_GENERATIONPIPELINE_H
+#define FARFIELD_GENERATIONPIPELINE_H
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "NeighborAccess.h"
+#include "Chunk.h"
+#include "JobSystem.h"
+
+// One world generation pass. Radii are in chunks and limited to the 3x3x3 neighborhood:
+// readRadius 1 lets the stage read its neighbors' blocks, writeRadius 1 lets it spill blocks into them.
+// Its steps, merge included, are queued under its job priority class
+struct GenerationStage {
+    std::string name;
+    int readRadius = 0;
+    int writeRadius = 0;
+    JobPriority priority = JobPriority::TERRAIN;
+    std::function<void(Chunk&, NeighborAccess&)> run;
+};
+
+// Schedulable unit, a stage run or the merge of the edits a stage spilled into the chunk
+struct GenerationStep {
+    std::size_t stage;
+    bool merge;
+    int readRadius;
+    int writeRadius;
+    uint32_t dependencies; // Neighbors that must have completed the previous step
+};
+
+struct StepMetrics {
+    // Log-linear latency histogram, 4 buckets per power of two (values below 4ns get their own bucket)
+    static constexpr std::size_t BUCKETS_PER_OCTAVE = 4;
+    static constexpr std::size_t BUCKET_COUNT = 256;
+
+    std::atomic<uint64_t> runCount{0};
+    std::atomic<uint64_t> totalNanoseconds{0};
+    std::atomic<uint64_t> maxNanoseconds{0};
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+
+    void record(uint64_t nanoseconds);
+
+    [[nodiscard]] double getAverageMs() const;
+    [[nodiscard]] double getMaxMs() const;
+    // Run time under which a fraction p in [0, 1] of the runs finished, within 1/8 of the true value
+    [[nodiscard]] double getPercentileMs(double p) const;
+
+    [[nodiscard]] static std::size_t getBucket(uint64_t nanoseconds);
+    [[nodiscard]] static uint64_t getBucketMidpoint(std::size_t bucket);
+};
+
+class GenerationPipeline {
+    public:
+        using ChunkGetter = std::function<Chunk*(const ChunkPos&)>;
+
+        GenerationPipeline& addStage(GenerationStage stage);
+
+        // Runs one step on a chunk and records its timing
+        void runStep(std::size_t stepIndex, Chunk& chunk, const ChunkGetter& getChunk);
+
+        [[nodiscard]] std::size_t getStepCount() const { return this->steps.size(); }
+        [[nodiscard]] const GenerationStep& getStep(const std::size_t index) const { return this->steps[index]; }
+        [[nodiscard]] const GenerationStage& getStage(const std::size_t index) const { return this->stages[index]; }
+        [[nodiscard]] std::string getStepName(std::size_t index) const;
+        [[nodiscard]] JobPriority getStepPriority(const std::size_t index) const { return this->stages[this->steps[index].stage].priority; }
+        // Distinct priority classes of the stages, in stage order
+        [[nodiscard]] const std::vector<JobPriority>& getPriorities() const { return this->priorities; }
+        [[nodiscard]] const StepMetrics& getMetrics(const std::size_t index) const { return this->metrics[index]; }
+
+    private:
+        std::vector<GenerationStage> stages;
+        std::vector<GenerationStep> steps;
+        std::vector<JobPriority> priorities;
+        std::array<StepMetrics, Chunk::MAX_GENERATION_STEPS> metrics;
+
+        void addStep(std::size_t stage, bool merge, int readRadius, int writeRadius);
+        static uint32_t radiusMask(int radius);
+};
+
+#endif
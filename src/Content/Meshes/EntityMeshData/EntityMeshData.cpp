@@ -14,3 +14,8 @@ void EntityMeshData::render() const
 {
     this->vao.draw();
 }
+
+void EntityMeshData::renderInstanced(const GLsizei instanceCount, const GLuint baseInstance) const
+{
+    this->vao.drawInstanced(instanceCount, baseInstance);
+}
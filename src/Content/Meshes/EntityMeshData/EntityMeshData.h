@@ -22,6 +22,8 @@ class EntityMeshData
 
         void upload(const std::vector<EntityVertex>& vertices);
         void render() const;
+        // One draw of instanceCount copies, reading the instances from baseInstance on
+        void renderInstanced(GLsizei instanceCount, GLuint baseInstance) const;
 };
 
 #endif
\ No newline at end of file
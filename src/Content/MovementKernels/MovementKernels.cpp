@@ -0,0 +1,430 @@
+#include "MovementKernels.h"
+#include "SimdTarget.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace {
+    constexpr float MIN_SPEED = MovementKernels::MIN_SPEED;
+
+    constexpr float PI = 3.14159265358979323846f;
+    constexpr float HALF_PI = PI / 2.f;
+    constexpr float DEGREES = 57.295779513082320876798f;
+
+    // Odd minimax polynomial for atan on [0, 1], max error about 1e-5 rad
+    constexpr float ATAN_1 = 0.99997726f;
+    constexpr float ATAN_3 = -0.33262347f;
+    constexpr float ATAN_5 = 0.19354346f;
+    constexpr float ATAN_7 = -0.11643287f;
+    constexpr float ATAN_9 = 0.05265332f;
+    constexpr float ATAN_11 = -0.01172120f;
+
+    // Components are read as strided float arrays
+    static_assert(sizeof(ECS::Position) == 3 * sizeof(float) && sizeof(ECS::Velocity) == 3 * sizeof(float) && sizeof(ECS::Rotation) == 3 * sizeof(float));
+    static_assert(sizeof(ECS::Gravity) == 2 * sizeof(float));
+    static_assert(sizeof(ECS::CollisionBox) % sizeof(int) == 0 && offsetof(ECS::CollisionBox, isGrounded) + sizeof(int) <= sizeof(ECS::CollisionBox));
+
+    constexpr int VECTOR_STRIDE = 3;
+    constexpr int GRAVITY_STRIDE = 2;
+    constexpr int BOX_STRIDE = sizeof(ECS::CollisionBox) / sizeof(int);
+
+    // The stepped integration works on blocks of 8 entities, 3 AVX2 or 6 SSE vectors
+    constexpr int STEP_BLOCK = 8;
+
+    // Every backend runs the same operations in the same order, so they agree bit for bit
+    float fastAtan2(const float y, const float x)
+    {
+        const float ax = std::abs(x);
+        const float ay = std::abs(y);
+        const float a = std::min(ax, ay) / std::max(ax, ay);
+        const float s = a * a;
+
+        float r = ((((ATAN_11 * s + ATAN_9) * s + ATAN_7) * s + ATAN_5) * s + ATAN_3) * s + ATAN_1;
+        r = r * a;
+
+        if (ay > ax)
+            r = HALF_PI - r;
+        if (x < 0.f)
+            r = PI - r;
+        return std::copysign(r, y);
+    }
+
+    void integrateScalar(float* pos, const float* vel, const std::size_t from, const std::size_t count)
+    {
+        for (std::size_t i = from; i < count; i++)
+            pos[i] += vel[i];
+    }
+
+    // Entities instead of floats, pos + vel * steps like the SIMD bodies
+    void integrateStepsScalar(float* pos, const float* vel, const ECS::TickLod* lods, const std::size_t from, const std::size_t count)
+    {
+        for (std::size_t i = from; i < count; i++) {
+            const auto steps = static_cast<float>(lods[i].steps);
+            for (std::size_t f = i * VECTOR_STRIDE; f < (i + 1) * VECTOR_STRIDE; f++)
+                pos[f] += vel[f] * steps;
+        }
+    }
+
+    // Each float of a block scaled by the steps of its entity
+    void fillStepScales(float* scales, const ECS::TickLod* lods)
+    {
+        for (int e = 0; e < STEP_BLOCK; e++)
+            for (int c = 0; c < VECTOR_STRIDE; c++)
+                scales[e * VECTOR_STRIDE + c] = static_cast<float>(lods[e].steps);
+    }
+
+    // Largest steps of a block, how many times the SIMD bodies step it
+    int getBlockSteps(const ECS::TickLod* lods, const int n)
+    {
+        int steps = 0;
+        for (int e = 0; e < n; e++)
+            steps = std::max<int>(steps, lods[e].steps);
+        return steps;
+    }
+
+    void applyGravityScalar(ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const ECS::TickLod* lods, const std::size_t from, const std::size_t count)
+    {
+        for (std::size_t i = from; i < count; i++) {
+            const int steps = lods ? lods[i].steps : 1;
+
+            for (int step = 0; step < steps; step++) {
+                const float fallen = vel[i].y - gravity[i].strength;
+                vel[i].y = boxes[i].isGrounded ? -gravity[i].strength : (fallen < gravity[i].terminalVelocity ? gravity[i].terminalVelocity : fallen);
+            }
+        }
+    }
+
+    void faceVelocityScalar(ECS::Rotation* rot, const ECS::Velocity* vel, const ECS::TickLod* lods, const std::size_t from, const std::size_t count)
+    {
+        for (std::size_t i = from; i < count; i++) {
+            if (lods && lods[i].steps == 0)
+                continue;
+            if (std::sqrt(vel[i].x * vel[i].x + vel[i].z * vel[i].z) < MIN_SPEED)
+                continue;
+
+            rot[i].y = (fastAtan2(vel[i].x, vel[i].z) + PI) * DEGREES;
+        }
+    }
+}
+
+MovementKernels::MovementKernels() :
+    backend(CpuFeatures::detectSimdLevel())
+{}
+
+void MovementKernels::setBackend(const Backend _backend)
+{
+    this->backend = std::min(_backend, CpuFeatures::detectSimdLevel());
+}
+
+#ifdef FARFIELD_SIMD_X86
+
+// SIMD bodies return how many elements they handled, the scalar code finishes the tail
+namespace {
+    FARFIELD_TARGET("sse4.1")
+    std::size_t integrateSse41(float* pos, const float* vel, const std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(pos + i, _mm_add_ps(_mm_loadu_ps(pos + i), _mm_loadu_ps(vel + i)));
+        return i;
+    }
+
+    // Counts entities, not floats
+    FARFIELD_TARGET("sse4.1")
+    std::size_t integrateStepsSse41(float* pos, const float* vel, const ECS::TickLod* lods, const std::size_t count)
+    {
+        alignas(16) float scales[STEP_BLOCK * VECTOR_STRIDE];
+        std::size_t i = 0;
+
+        for (; i + STEP_BLOCK <= count; i += STEP_BLOCK) {
+            fillStepScales(scales, lods + i);
+
+            float* const p = pos + i * VECTOR_STRIDE;
+            const float* const v = vel + i * VECTOR_STRIDE;
+            for (int f = 0; f < STEP_BLOCK * VECTOR_STRIDE; f += 4)
+                _mm_storeu_ps(p + f, _mm_add_ps(_mm_loadu_ps(p + f), _mm_mul_ps(_mm_loadu_ps(v + f), _mm_load_ps(scales + f))));
+        }
+        return i;
+    }
+
+    // Lanes of the entities with more than step steps
+    FARFIELD_TARGET("sse4.1")
+    __m128 isSteppingSse41(const ECS::TickLod* lods, const int step)
+    {
+        const __m128i steps = _mm_setr_epi32(lods[0].steps, lods[1].steps, lods[2].steps, lods[3].steps);
+        return _mm_castsi128_ps(_mm_cmpgt_epi32(steps, _mm_set1_epi32(step)));
+    }
+
+    FARFIELD_TARGET("sse4.1")
+    std::size_t applyGravitySse41(ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const ECS::TickLod* lods, const std::size_t count)
+    {
+        alignas(16) float out[4];
+        std::size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            // Entities catching up on several ticks are stepped in registers, as often as the block's largest steps
+            const int steps = lods ? getBlockSteps(lods + i, 4) : 1;
+            if (steps == 0)
+                continue;
+
+            __m128 y = _mm_setr_ps(vel[i].y, vel[i + 1].y, vel[i + 2].y, vel[i + 3].y);
+            const __m128 strength = _mm_setr_ps(gravity[i].strength, gravity[i + 1].strength, gravity[i + 2].strength, gravity[i + 3].strength);
+            const __m128 terminal = _mm_setr_ps(gravity[i].terminalVelocity, gravity[i + 1].terminalVelocity, gravity[i + 2].terminalVelocity, gravity[i + 3].terminalVelocity);
+            const __m128i grounded = _mm_setr_epi32(boxes[i].isGrounded, boxes[i + 1].isGrounded, boxes[i + 2].isGrounded, boxes[i + 3].isGrounded);
+
+            const __m128 pushed = _mm_xor_ps(strength, _mm_set1_ps(-0.f));
+            const __m128 isGrounded = _mm_castsi128_ps(_mm_cmpgt_epi32(grounded, _mm_setzero_si128()));
+
+            for (int step = 0; step < steps; step++) {
+                const __m128 fallen = _mm_max_ps(terminal, _mm_sub_ps(y, strength));
+                const __m128 result = _mm_blendv_ps(fallen, pushed, isGrounded);
+
+                y = lods ? _mm_blendv_ps(y, result, isSteppingSse41(lods + i, step)) : result;
+            }
+
+            _mm_store_ps(out, y);
+            for (std::size_t lane = 0; lane < 4; lane++)
+                vel[i + lane].y = out[lane];
+        }
+        return i;
+    }
+
+    FARFIELD_TARGET("sse4.1")
+    __m128 fastAtan2Sse41(const __m128 y, const __m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.f);
+        const __m128 ax = _mm_andnot_ps(signMask, x);
+        const __m128 ay = _mm_andnot_ps(signMask, y);
+        const __m128 a = _mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(ax, ay));
+        const __m128 s = _mm_mul_ps(a, a);
+
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_11), s), _mm_set1_ps(ATAN_9));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_7));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_5));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_3));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(ATAN_1));
+        r = _mm_mul_ps(r, a);
+
+        r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(HALF_PI), r), _mm_cmpgt_ps(ay, ax));
+        r = _mm_blendv_ps(r, _mm_sub_ps(_mm_set1_ps(PI), r), _mm_cmplt_ps(x, _mm_setzero_ps()));
+        return _mm_or_ps(r, _mm_and_ps(y, signMask));
+    }
+
+    FARFIELD_TARGET("sse4.1")
+    std::size_t faceVelocitySse41(ECS::Rotation* rot, const ECS::Velocity* vel, const ECS::TickLod* lods, const std::size_t count)
+    {
+        alignas(16) float out[4];
+        std::size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            const __m128 x = _mm_setr_ps(vel[i].x, vel[i + 1].x, vel[i + 2].x, vel[i + 3].x);
+            const __m128 z = _mm_setr_ps(vel[i].z, vel[i + 1].z, vel[i + 2].z, vel[i + 3].z);
+            const __m128 previous = _mm_setr_ps(rot[i].y, rot[i + 1].y, rot[i + 2].y, rot[i + 3].y);
+
+            const __m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z)));
+            __m128 moving = _mm_cmpnlt_ps(speed, _mm_set1_ps(MIN_SPEED));
+            if (lods)
+                moving = _mm_and_ps(moving, isSteppingSse41(lods + i, 0));
+            const __m128 angle = _mm_mul_ps(_mm_add_ps(fastAtan2Sse41(x, z), _mm_set1_ps(PI)), _mm_set1_ps(DEGREES));
+
+            _mm_store_ps(out, _mm_blendv_ps(previous, angle, moving));
+            for (std::size_t lane = 0; lane < 4; lane++)
+                rot[i + lane].y = out[lane];
+        }
+        return i;
+    }
+
+    FARFIELD_TARGET("avx2")
+    std::size_t integrateAvx2(float* pos, const float* vel, const std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(pos + i, _mm256_add_ps(_mm256_loadu_ps(pos + i), _mm256_loadu_ps(vel + i)));
+        return i;
+    }
+
+    FARFIELD_TARGET("avx2")
+    std::size_t integrateStepsAvx2(float* pos, const float* vel, const ECS::TickLod* lods, const std::size_t count)
+    {
+        alignas(32) float scales[STEP_BLOCK * VECTOR_STRIDE];
+        std::size_t i = 0;
+
+        for (; i + STEP_BLOCK <= count; i += STEP_BLOCK) {
+            fillStepScales(scales, lods + i);
+
+            float* const p = pos + i * VECTOR_STRIDE;
+            const float* const v = vel + i * VECTOR_STRIDE;
+            for (int f = 0; f < STEP_BLOCK * VECTOR_STRIDE; f += 8)
+                _mm256_storeu_ps(p + f, _mm256_add_ps(_mm256_loadu_ps(p + f), _mm256_mul_ps(_mm256_loadu_ps(v + f), _mm256_load_ps(scales + f))));
+        }
+        return i;
+    }
+
+    // TickLod is 3 bytes, a gather would read past the end of the column
+    FARFIELD_TARGET("avx2")
+    __m256 isSteppingAvx2(const ECS::TickLod* lods, const int step)
+    {
+        const __m256i steps = _mm256_setr_epi32(lods[0].steps, lods[1].steps, lods[2].steps, lods[3].steps, lods[4].steps, lods[5].steps, lods[6].steps, lods[7].steps);
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(steps, _mm256_set1_epi32(step)));
+    }
+
+    FARFIELD_TARGET("avx2")
+    __m256i strideIndexAvx2(const int stride)
+    {
+        return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+    }
+
+    FARFIELD_TARGET("avx2")
+    std::size_t applyGravityAvx2(ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const ECS::TickLod* lods, const std::size_t count)
+    {
+        const __m256i vectorIndex = strideIndexAvx2(VECTOR_STRIDE);
+        const __m256i gravityIndex = strideIndexAvx2(GRAVITY_STRIDE);
+        const __m256i boxIndex = strideIndexAvx2(BOX_STRIDE);
+
+        alignas(32) float out[8];
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            // Entities catching up on several ticks are stepped in registers, as often as the block's largest steps
+            const int steps = lods ? getBlockSteps(lods + i, 8) : 1;
+            if (steps == 0)
+                continue;
+
+            __m256 y = _mm256_i32gather_ps(&vel[i].y, vectorIndex, 4);
+            const __m256 strength = _mm256_i32gather_ps(&gravity[i].strength, gravityIndex, 4);
+            const __m256 terminal = _mm256_i32gather_ps(&gravity[i].terminalVelocity, gravityIndex, 4);
+
+            // isGrounded is gathered with the padding after it, only its byte matters
+            const __m256i groundedWord = _mm256_i32gather_epi32(reinterpret_cast<const int*>(&boxes[i].isGrounded), boxIndex, 4);
+            const __m256i grounded = _mm256_and_si256(groundedWord, _mm256_set1_epi32(0xFF));
+
+            const __m256 pushed = _mm256_xor_ps(strength, _mm256_set1_ps(-0.f));
+            const __m256 isGrounded = _mm256_castsi256_ps(_mm256_cmpgt_epi32(grounded, _mm256_setzero_si256()));
+
+            for (int step = 0; step < steps; step++) {
+                const __m256 fallen = _mm256_max_ps(terminal, _mm256_sub_ps(y, strength));
+                const __m256 result = _mm256_blendv_ps(fallen, pushed, isGrounded);
+
+                y = lods ? _mm256_blendv_ps(y, result, isSteppingAvx2(lods + i, step)) : result;
+            }
+
+            _mm256_store_ps(out, y);
+            for (std::size_t lane = 0; lane < 8; lane++)
+                vel[i + lane].y = out[lane];
+        }
+        return i;
+    }
+
+    FARFIELD_TARGET("avx2")
+    __m256 fastAtan2Avx2(const __m256 y, const __m256 x)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.f);
+        const __m256 ax = _mm256_andnot_ps(signMask, x);
+        const __m256 ay = _mm256_andnot_ps(signMask, y);
+        const __m256 a = _mm256_div_ps(_mm256_min_ps(ax, ay), _mm256_max_ps(ax, ay));
+        const __m256 s = _mm256_mul_ps(a, a);
+
+        __m256 r = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(ATAN_11), s), _mm256_set1_ps(ATAN_9));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(ATAN_7));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(ATAN_5));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(ATAN_3));
+        r = _mm256_add_ps(_mm256_mul_ps(r, s), _mm256_set1_ps(ATAN_1));
+        r = _mm256_mul_ps(r, a);
+
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(HALF_PI), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+        r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(PI), r), _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ));
+        return _mm256_or_ps(r, _mm256_and_ps(y, signMask));
+    }
+
+    FARFIELD_TARGET("avx2")
+    std::size_t faceVelocityAvx2(ECS::Rotation* rot, const ECS::Velocity* vel, const ECS::TickLod* lods, const std::size_t count)
+    {
+        const __m256i vectorIndex = strideIndexAvx2(VECTOR_STRIDE);
+
+        alignas(32) float out[8];
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            const __m256 x = _mm256_i32gather_ps(&vel[i].x, vectorIndex, 4);
+            const __m256 z = _mm256_i32gather_ps(&vel[i].z, vectorIndex, 4);
+            const __m256 previous = _mm256_i32gather_ps(&rot[i].y, vectorIndex, 4);
+
+            const __m256 speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(z, z)));
+            __m256 moving = _mm256_cmp_ps(speed, _mm256_set1_ps(MIN_SPEED), _CMP_NLT_UQ);
+            if (lods)
+                moving = _mm256_and_ps(moving, isSteppingAvx2(lods + i, 0));
+            const __m256 angle = _mm256_mul_ps(_mm256_add_ps(fastAtan2Avx2(x, z), _mm256_set1_ps(PI)), _mm256_set1_ps(DEGREES));
+
+            _mm256_store_ps(out, _mm256_blendv_ps(previous, angle, moving));
+            for (std::size_t lane = 0; lane < 8; lane++)
+                rot[i + lane].y = out[lane];
+        }
+        return i;
+    }
+}
+
+#endif
+
+void MovementKernels::integrateColumns(ECS::Position* pos, const ECS::Velocity* vel, const std::size_t count) const
+{
+    // Both columns are plain float arrays, entity boundaries don't matter for an elementwise add
+    float* const p = &pos->x;
+    const float* const v = &vel->x;
+    const std::size_t floats = count * VECTOR_STRIDE;
+    std::size_t done = 0;
+
+#ifdef FARFIELD_SIMD_X86
+    switch (this->backend) {
+        case Backend::AVX2: done = integrateAvx2(p, v, floats); break;
+        case Backend::SSE41: done = integrateSse41(p, v, floats); break;
+        default: break;
+    }
+#endif
+    integrateScalar(p, v, done, floats);
+}
+
+void MovementKernels::integrate(ECS::Position* pos, const ECS::Velocity* vel, const ECS::TickLod* lods, const std::size_t count) const
+{
+    float* const p = &pos->x;
+    const float* const v = &vel->x;
+    std::size_t done = 0;
+
+#ifdef FARFIELD_SIMD_X86
+    switch (this->backend) {
+        case Backend::AVX2: done = integrateStepsAvx2(p, v, lods, count); break;
+        case Backend::SSE41: done = integrateStepsSse41(p, v, lods, count); break;
+        default: break;
+    }
+#endif
+    integrateStepsScalar(p, v, lods, done, count);
+}
+
+void MovementKernels::applyGravityColumns(ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const ECS::TickLod* lods, const std::size_t count) const
+{
+    std::size_t done = 0;
+
+#ifdef FARFIELD_SIMD_X86
+    switch (this->backend) {
+        case Backend::AVX2: done = applyGravityAvx2(vel, gravity, boxes, lods, count); break;
+        case Backend::SSE41: done = applyGravitySse41(vel, gravity, boxes, lods, count); break;
+        default: break;
+    }
+#endif
+    applyGravityScalar(vel, gravity, boxes, lods, done, count);
+}
+
+void MovementKernels::faceVelocity(ECS::Rotation* rot, const ECS::Velocity* vel, const ECS::TickLod* lods, const std::size_t count) const
+{
+    std::size_t done = 0;
+
+#ifdef FARFIELD_SIMD_X86
+    switch (this->backend) {
+        case Backend::AVX2: done = faceVelocityAvx2(rot, vel, lods, count); break;
+        case Backend::SSE41: done = faceVelocitySse41(rot, vel, lods, count); break;
+        default: break;
+    }
+#endif
+    faceVelocityScalar(rot, vel, lods, done, count);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef FARFIELD_MOVEMENTKERNELS_H
+#define FARFIELD_MOVEMENTKERNELS_H
+
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "CpuFeatures.h"
+#include "Components/Movements.h"
+#include "Components/Gravity.h"
+#include "Components/CollisionBox.h"
+#include "Components/TickLod.h"
+
+// Batched bodies of the movement systems, run over whole component columns (see ECS forEachChunk).
+// integrate and applyGravity give the same results as the per entity code bit for bit on every backend.
+// faceVelocity uses a polynomial atan2 (error below 1e-3 degrees), the same one on every backend.
+// The TickLod overloads run the same bodies on the whole column for lods[i].steps ticks of each entity
+class MovementKernels {
+    public:
+        using Backend = CpuFeatures::SimdLevel;
+
+        // Rotation of entities moving slower than this is left alone, their velocity direction is mostly noise
+        static constexpr float MIN_SPEED = 0.0001f;
+
+        MovementKernels();
+
+        // pos[i] += vel[i]
+        void integrate(ECS::Position* pos, const ECS::Velocity* vel, const std::size_t count) const
+        {
+            // Sparse set storage mostly hands out single entities, they're not worth a backend dispatch
+            if (count == 1)
+                *pos += static_cast<const glm::vec3&>(*vel);
+            else
+                this->integrateColumns(pos, vel, count);
+        }
+
+        // pos[i] += vel[i] * lods[i].steps, entities catching up on skipped ticks move the whole way at once
+        void integrate(ECS::Position* pos, const ECS::Velocity* vel, const ECS::TickLod* lods, std::size_t count) const;
+
+        // Grounded entities get pushed against the ground, the others fall up to their terminal velocity
+        void applyGravity(ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const std::size_t count) const
+        {
+            if (count == 1)
+                vel->y = boxes->isGrounded ? -gravity->strength : glm::max(vel->y - gravity->strength, gravity->terminalVelocity);
+            else
+                this->applyGravityColumns(vel, gravity, boxes, nullptr, count);
+        }
+
+        // applyGravity lods[i].steps times on each entity
+        void applyGravity(ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const ECS::TickLod* lods, const std::size_t count) const
+        {
+            this->applyGravityColumns(vel, gravity, boxes, lods, count);
+        }
+
+        // Turns rot.y (degrees) towards the horizontal velocity, entities barely moving keep their rotation
+        void faceVelocity(ECS::Rotation* rot, const ECS::Velocity* vel, const std::size_t count) const
+        {
+            this->faceVelocity(rot, vel, nullptr, count);
+        }
+
+        // Facing doesn't depend on elapsed time, entities with no steps this tick keep their rotation
+        void faceVelocity(ECS::Rotation* rot, const ECS::Velocity* vel, const ECS::TickLod* lods, std::size_t count) const;
+
+        // Whether faceVelocity turns an entity
+        static bool isFacingVelocity(const ECS::Velocity& vel)
+        {
+            return !(std::sqrt(vel.x * vel.x + vel.z * vel.z) < MIN_SPEED);
+        }
+
+        // Backends the CPU doesn't support fall back to the best supported one
+        void setBackend(Backend _backend);
+        [[nodiscard]] Backend getBackend() const { return this->backend; }
+
+    private:
+        Backend backend;
+
+        void integrateColumns(ECS::Position* pos, const ECS::Velocity* vel, std::size_t count) const;
+        // One step per entity when lods is null
+        void applyGravityColumns(ECS::Velocity* vel, const ECS::Gravity* gravity, const ECS::CollisionBox* boxes, const ECS::TickLod* lods, std::size_t count) const;
+};
+
+#endif
\ No newline at end of file
@@ -1,13 +1,16 @@
 #include "NeighborAccess.h"
 
-NeighborAccess::NeighborAccess(const ChunkPos& _centerPos, std::function<Chunk*(const ChunkPos&)> getChunk) :
-    centerPos(_centerPos)
+NeighborAccess::NeighborAccess(const ChunkPos& _centerPos, const std::function<Chunk*(const ChunkPos&)>& getChunk, const uint8_t _stage, const int _readRadius, const int _writeRadius) :
+    centerPos(_centerPos),
+    stage(_stage),
+    readRadius(_readRadius),
+    writeRadius(_writeRadius)
 {
-    this->chunkModified.fill(false);
-    
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dz = -1; dz <= 1; dz++) {
-            for (int dx = -1; dx <= 1; dx++) {
+    const int radius = std::max(_readRadius, _writeRadius);
+
+    for (int dy = -radius; dy <= radius; dy++) {
+        for (int dz = -radius; dz <= radius; dz++) {
+            for (int dx = -radius; dx <= radius; dx++) {
                 ChunkPos neighborPos = {
                     _centerPos.x + dx,
                     _centerPos.y + dy,
@@ -20,67 +23,71 @@ NeighborAccess::NeighborAccess(const ChunkPos& _centerPos, std::function<Chunk*(
     }
 }
 
-bool NeighborAccess::allNeighborsReady() const
-{
-    // Check all 27 positions in the 3x3x3 neighborhood
-    for (int dy = -1; dy <= 1; dy++) {
-        for (int dz = -1; dz <= 1; dz++) {
-            for (int dx = -1; dx <= 1; dx++) {
-                const int index = offsetToIndex(dx, dy, dz);
-                const Chunk* chunk = this->chunks[index];
-
-                const int neighborY = this->centerPos.y + dy;
-
-                if (chunk == nullptr) {
-                    if (neighborY >= 0)
-                        return false;
-                    continue;
-                }
-
-                if (!hasTerrainComplete(chunk->getState()))
-                    return false;
-            }
-        }
-    }
-    return true;
-}
-
 Material NeighborAccess::getBlock(const int wx, const int wy, const int wz) const
 {
-    const Chunk* chunk = getChunkForWorldPos(wx, wy, wz);
+    const int index = this->getIndexForWorldPos(wx, wy, wz);
 
-    if (!chunk)
+    if (index < 0 || (index != 13 && this->readRadius == 0) || !this->chunks[index])
         return Material();
 
     const auto [x, y, z] = BlockPos::fromWorld(wx, wy, wz);
-    return chunk->getBlock(x, y, z);
+    return this->chunks[index]->getBlock(x, y, z);
 }
 
-void NeighborAccess::setBlock(const int wx, const int wy, const int wz, const Material mat)
+void NeighborAccess::placeBlock(const int wx, const int wy, const int wz, const Material mat)
 {
-    const auto [cx, cy, cz] = ChunkPos::fromWorld(wx, wy, wz);
+    const int index = this->getIndexForWorldPos(wx, wy, wz);
 
-    const int dx = cx - this->centerPos.x;
-    const int dy = cy - this->centerPos.y;
-    const int dz = cz - this->centerPos.z;
+    // Silently ignore blocks outside the stage's write radius
+    if (index < 0 || (index != 13 && this->writeRadius == 0))
+        return;
+
+    const auto [x, y, z] = BlockPos::fromWorld(wx, wy, wz);
 
-    // Check if within 3x3x3 neighborhood - silently ignore blocks outside
-    if (dx < -1 || dx > 1 || dy < -1 || dy > 1 || dz < -1 || dz > 1) {
+    if (index == 13) {
+        if (this->chunks[index]->isAir(x, y, z))
+            this->chunks[index]->setBlockDirect(x, y, z, mat);
         return;
     }
 
-    const int index = offsetToIndex(dx, dy, dz);
+    // Every spill takes its number even when it is skipped, so a reloaded source numbers its edits
+    // exactly like its first run and duplicates left in unfinished neighbors still line up
+    const uint32_t sequence = this->spillSequence++;
     Chunk* chunk = this->chunks[index];
 
-    if (chunk && hasTerrainComplete(chunk->getState())) {
+    // A generated neighbor already merged this chunk's edits before it was reloaded
+    if (chunk && !isFullyGenerated(chunk->getState())) {
+        chunk->addPendingEdit({
+            this->centerPos,
+            sequence,
+            static_cast<uint16_t>(ChunkPos::localCoordsToIndex(x, y, z)),
+            this->stage,
+            mat
+        });
+    }
+}
+
+void NeighborAccess::placeSpan(int wx, const int wy, const int wz, int length, const Material mat)
+{
+    while (length > 0) {
         const auto [x, y, z] = BlockPos::fromWorld(wx, wy, wz);
+        const int piece = std::min(length, Chunk::SIZE - x);
+        const int index = this->getIndexForWorldPos(wx, wy, wz);
 
-        chunk->setBlockDirect(x, y, z, mat);
-        this->chunkModified[index] = true;
+        if (index == 13) {
+            this->chunks[index]->placeRowDirect(x, y, z, piece, mat);
+        }
+        else {
+            for (int i = 0; i < piece; i++)
+                this->placeBlock(wx + i, wy, wz, mat);
+        }
+
+        wx += piece;
+        length -= piece;
     }
 }
 
-Chunk* NeighborAccess::getChunkForWorldPos(const int wx, const int wy, const int wz) const
+int NeighborAccess::getIndexForWorldPos(const int wx, const int wy, const int wz) const
 {
     const auto [cx, cy, cz] = ChunkPos::fromWorld(wx, wy, wz);
 
@@ -89,15 +96,7 @@ Chunk* NeighborAccess::getChunkForWorldPos(const int wx, const int wy, const int
     const int dz = cz - this->centerPos.z;
 
     if (dx < -1 || dx > 1 || dy < -1 || dy > 1 || dz < -1 || dz > 1)
-        return nullptr;
+        return -1;
 
-    return this->chunks[offsetToIndex(dx, dy, dz)];
-}
-
-void NeighborAccess::markDirtyChunks() const
-{
-    for (int i = 0; i < 27; i++) {
-        if (this->chunkModified[i] && this->chunks[i])
-            this->chunks[i]->setDirty(true);
-    }
+    return offsetToIndex(dx, dy, dz);
 }
@@ -8,29 +8,35 @@
 
 class NeighborAccess {
     public:
-        NeighborAccess(const ChunkPos& _centerPos, std::function<Chunk*(const ChunkPos&)> getChunk);
+        // Radii follow the generation stage being run, chunks outside of them read as missing
+        NeighborAccess(const ChunkPos& _centerPos, const std::function<Chunk*(const ChunkPos&)>& getChunk, uint8_t _stage, int _readRadius, int _writeRadius);
 
         Chunk* getCenter() const { return this->chunks[13]; }
 
         Material getBlock(int wx, int wy, int wz) const;
-        void setBlock(int wx, int wy, int wz, Material mat);
 
-        bool allNeighborsReady() const;
-        void markDirtyChunks() const;
+        // Places a block over air only. Blocks outside the center chunk are spilled to the
+        // target chunk and merged when it has run the stage's merge step
+        void placeBlock(int wx, int wy, int wz, Material mat);
+        // Same as placeBlock for a run of length blocks along +x, split at chunk borders
+        void placeSpan(int wx, int wy, int wz, int length, Material mat);
 
     private:
         ChunkPos centerPos;
-        std::array<Chunk*, 27> chunks;
-        std::array<bool, 27> chunkModified;
+        std::array<Chunk*, 27> chunks{};
+        uint8_t stage;
+        int readRadius;
+        int writeRadius;
+        uint32_t spillSequence = 0;
 
         // Convert 3D offset (-1,0,1) to array index (0-26)
         static int offsetToIndex(int dx, int dy, int dz) {
             return (dx + 1) + (dy + 1) * 3 + (dz + 1) * 9;
         }
 
-        // Get chunk containing world position
-        Chunk* getChunkForWorldPos(int wx, int wy, int wz) const;
+        // Get chunk containing world position, -1 when outside the neighborhood
+        int getIndexForWorldPos(int wx, int wy, int wz) const;
 };
 
 
-#endif
\ No newline at end of file
+#endif
@@ -24,6 +24,7 @@ BlockId BlockRegistry::registerBlock(const BlockMeta& meta)
 
     this->blocks.push_back(meta);
     this->nameToBlockId.emplace(meta.getFullName(), id);
+    this->transparency.push_back(meta.transparent);
 
     return id;
 }
@@ -13,7 +13,7 @@
 #include <json.hpp>
 
 #include "Material.h"
-#include "TextureRegistry.h"
+#include "TextureNames.h"
 
 using json = nlohmann::json;
 using BlockFaces = std::map<MaterialFace, std::string>;
@@ -59,7 +59,7 @@ struct BlockMeta
         const auto it = blockFaces.find(face);
 
         if (it == blockFaces.end())
-            return TextureRegistry::MISSING;
+            return TextureNames::MISSING;
         return it->second;
     }
 };
@@ -68,6 +68,7 @@ class BlockRegistry
 {
     std::vector<BlockMeta> blocks;
     std::unordered_map<std::string, BlockId> nameToBlockId;
+    std::vector<uint8_t> transparency; // Flat copy of BlockMeta::transparent for per block queries
 
     static BlockFaces uniformBlockFaces(std::string texture);
 
@@ -82,6 +83,13 @@ class BlockRegistry
         bool isEqual(BlockId id, const std::string& name) const;
         bool isAir(BlockId id) const;
 
+        [[nodiscard]] bool isTransparent(const BlockId id) const
+        {
+            if (id >= this->transparency.size())
+                throw std::out_of_range("[BlockRegistry::isTransparent] Out of range BlockID : " + std::to_string(id));
+            return this->transparency[id] != 0;
+        }
+
         std::vector<BlockId> getAll() const;
 };
 
@@ -34,6 +34,7 @@ PrefabId PrefabRegistry::registerPrefab(const std::string& prefabFile)
         this->blockRegistry.getByName(data["block_below"].get<std::string>()),
         {}
     };
+    std::vector<PrefabBlockData> blocks;
 
     // Parse content (blocks)
     for (const auto& content : data["content"])
@@ -46,7 +47,7 @@ PrefabId PrefabRegistry::registerPrefab(const std::string& prefabFile)
         {
             const auto [x,y,z] = content["position"].get<std::array<short, 3>>();
 
-            meta.blocks.push_back({
+            blocks.push_back({
                 x, y, z, mat
             });
         }
@@ -61,7 +62,7 @@ PrefabId PrefabRegistry::registerPrefab(const std::string& prefabFile)
             for (short z = z1; z <= z2; z++)
                 for (short y = y1; y <= y2; y++)
                     for (short x = x1; x <= x2; x++)
-                        meta.blocks.push_back({x, y, z, mat});
+                        blocks.push_back({x, y, z, mat});
         }
         else if (content["command"].get<std::string>() == "FILL_RANGE")
         {
@@ -78,11 +79,14 @@ PrefabId PrefabRegistry::registerPrefab(const std::string& prefabFile)
                 for (short z = z1; z <= z2; z++)
                     for (short y = y1; y <= y2; y++)
                         for (short x = x1; x <= x2; x++)
-                            meta.blocks.push_back({x, y, z, mat});
+                            blocks.push_back({x, y, z, mat});
             }
         }
     }
 
+    for (int rotation = 0; rotation < PrefabMeta::ROTATIONS; rotation++)
+        meta.stamps[rotation] = this->compileStamp(blocks, rotation);
+
     auto id = static_cast<PrefabId>(this->prefabs.size());
 
     this->prefabs.push_back(meta);
@@ -92,6 +96,71 @@ PrefabId PrefabRegistry::registerPrefab(const std::string& prefabFile)
     return id;
 }
 
+PrefabStamp PrefabRegistry::compileStamp(const std::vector<PrefabBlockData>& blocks, const int quarterTurns) const
+{
+    // Keyed by (y, z, x) so runs along x come out contiguous
+    std::map<std::tuple<short, short, short>, Material> cells;
+
+    for (const auto& [x, y, z, mat] : blocks) {
+        short rx = x, rz = z;
+
+        for (int i = 0; i < quarterTurns; i++) {
+            const short previousX = rx;
+            rx = static_cast<short>(-rz);
+            rz = previousX;
+        }
+
+        cells.try_emplace({y, rz, rx}, this->rotateMaterial(mat, quarterTurns));
+    }
+
+    PrefabStamp stamp;
+
+    for (const auto& [key, mat] : cells) {
+        const auto [y, z, x] = key;
+
+        if (!stamp.spans.empty()) {
+            PrefabSpan& last = stamp.spans.back();
+
+            if (last.y == y && last.z == z && last.x + last.length == x && last.mat == mat && last.length < std::numeric_limits<uint8_t>::max()) {
+                last.length++;
+                continue;
+            }
+        }
+
+        stamp.spans.push_back({x, y, z, 1, mat});
+    }
+
+    return stamp;
+}
+
+Material PrefabRegistry::rotateMaterial(const Material mat, const int quarterTurns) const
+{
+    BlockRotation rotation = mat.getRotation();
+
+    switch (this->blockRegistry.get(mat.getBlockId()).rotation) {
+        case RotationType::NONE:
+            break;
+
+        case RotationType::HORIZONTAL:
+            {
+                // Facing after one turn, indexed by MaterialFace (NORTH, SOUTH, WEST, EAST)
+                constexpr BlockRotation TURN[4] = {EAST, WEST, NORTH, SOUTH};
+
+                for (int i = 0; i < quarterTurns; i++)
+                    rotation = TURN[rotation & 3];
+            }
+            break;
+
+        case RotationType::AXIS:
+            // Z (5) and X (6) swap on odd turns, vertical stays vertical
+            if (quarterTurns % 2 == 1 && (rotation == 5 || rotation == 6))
+                rotation = rotation == 5 ? 6 : 5;
+            break;
+    }
+
+    return Material::pack(mat.getBlockId(), rotation);
+}
+
 const PrefabMeta& PrefabRegistry::get(const PrefabId id) const
 {
     if (id >= this->prefabs.size())
@@ -4,7 +4,10 @@
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
+#include <map>
+#include <tuple>
 #include <vector>
+#include <array>
 
 #include <json.hpp>
 
@@ -22,11 +25,27 @@ struct PrefabBlockData
     Material mat;
 };
 
+// Run of identical blocks along +x, from the prefab origin
+struct PrefabSpan
+{
+    short x, y, z;
+    uint8_t length;
+    Material mat;
+};
+
+// Prefab compiled for one rotation, spans sorted by (y, z, x). Spans only ever replace air
+struct PrefabStamp
+{
+    std::vector<PrefabSpan> spans{};
+};
+
 struct PrefabMeta
 {
+    static constexpr int ROTATIONS = 4;
+
     int density;
     BlockId blockBelow;
-    std::vector<PrefabBlockData> blocks{};
+    std::array<PrefabStamp, ROTATIONS> stamps{}; // Quarter turns around Y, clockwise seen from above
 };
 
 class PrefabRegistry
@@ -38,6 +57,10 @@ class PrefabRegistry
 
     PrefabId registerPrefab(const std::string& prefabFile);
 
+    // Bakes the expanded blocks into spans, turned by quarterTurns. The first block listed at a position wins
+    [[nodiscard]] PrefabStamp compileStamp(const std::vector<PrefabBlockData>& blocks, int quarterTurns) const;
+    [[nodiscard]] Material rotateMaterial(Material mat, int quarterTurns) const;
+
     public:
         explicit PrefabRegistry(const BlockRegistry& _blockRegistry);
 
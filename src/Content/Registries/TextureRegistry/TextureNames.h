@@ -0,0 +1,15 @@
+#ifndef FARFIELD_TEXTURENAMES_H
+#define FARFIELD_TEXTURENAMES_H
+
+#pragma once
+
+#include <string>
+
+// Texture names needed without the GL side of the registry
+namespace TextureNames
+{
+    // Fallback texture, used for every face without one
+    inline constexpr std::string MISSING = "MISSING";
+}
+
+#endif
\ No newline at end of file
@@ -18,6 +18,8 @@
 #include <GLFW/glfw3.h>
 #include <stbi/stb_image.h>
 
+#include "TextureNames.h"
+
 namespace fs = std::filesystem;
 
 using TextureId = unsigned short;
@@ -80,7 +82,7 @@ class TextureRegistry
     std::unordered_map<std::string, TextureId> nameToTextureId;
 
     public:
-        static constexpr std::string MISSING = "MISSING";
+        static constexpr std::string MISSING = TextureNames::MISSING;
 
         TextureRegistry();
         ~TextureRegistry();
@@ -27,6 +27,8 @@ namespace ECS
         bool mouseCaptured = false;
 
         public:
+            using Access = ComponentAccess<const Position, Rotation, Camera>;
+
             explicit CameraSystem(const InputState& _inputs) : inputs(_inputs) {}
 
             void setAspect(const float a) { aspect = a; }
@@ -61,10 +63,13 @@ namespace ECS
                     lastY = inputs.mouseY;
                 }
 
-                auto view = handler.query<Position, Rotation, Camera>();
+                auto view = handler.query<const Position, Rotation, Camera>();
+                auto& rotations = handler.getPool<Rotation>();
 
-                view.forEach([&]([[maybe_unused]] EntityId id, [[maybe_unused]] const Position& pos, Rotation& rot, Camera& camera)
+                view.forEach([&](const EntityId id, const Position& pos, Rotation& rot, Camera& camera)
                 {
+                    const Rotation before = rot;
+
                     // Compute yaw/pitch from mouse delta
                     camera.yaw += static_cast<float>(dx * camera.sensitivity);
                     camera.pitch += static_cast<float>(dy * camera.sensitivity);
@@ -78,6 +83,9 @@ namespace ECS
                     rot.y = camera.yaw;
                     rot.x = camera.pitch;
 
+                    if (rot.x != before.x || rot.y != before.y)
+                        rotations.markChanged(id);
+
                     // Store matrices data
                     this->cameraPosition = pos + camera.eyeOffset;
                     this->viewMatrix = glm::lookAt(this->cameraPosition, this->cameraPosition + getForwardVector(camera), {0,1,0});
@@ -9,8 +9,11 @@ class World;
 #include "ECS/ISystem.h"
 #include "Components/Movements.h"
 #include "Components/CollisionBox.h"
+#include "Components/TickLod.h"
 
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace ECS
@@ -42,11 +45,27 @@ namespace ECS
         };
     }
 
+    // Entity resolutions, summed over every tick since the start
+    struct CollisionStats
+    {
+        std::uint64_t resolutions = 0; // Entities that ran this tick, each would be resolved without the resting skip
+        std::uint64_t resting = 0;     // Of those, the ones skipped as resting
+    };
+
     class CollisionSystem : public ISystem
     {
+        // Longest move resolved at once when an entity catches up on several ticks, shorter than a block so it can't tunnel
+        static constexpr float MAX_CATCH_UP_MOVE = 0.5f;
+
         World& world;
 
+        // Written from the workers of parallelForEach
+        std::atomic<std::uint64_t> resolutions{0};
+        std::atomic<std::uint64_t> resting{0};
+
         public:
+            using Access = ComponentAccess<Position, Velocity, CollisionBox, optional<const TickLod>>;
+
             explicit CollisionSystem(World& _world) : world(_world) {};
 
             bool resolveAxis(Position& pos, Velocity& vel, const glm::vec3& halfExt, const int axis, const float preAxisPos = std::numeric_limits<float>::quiet_NaN()) const
@@ -130,29 +149,81 @@ namespace ECS
                 return collided;
             }
 
+            // A grounded entity without horizontal velocity, standing on a block top and not moved by anything since the
+            // previous update would be pushed back to the same spot. Still checks a block holds it, in case it was removed
+            [[nodiscard]] bool isResting(const Position& pos, const Velocity& vel, const CollisionBox& box, const bool moved) const
+            {
+                if (moved || !box.isGrounded || vel.x != 0.0f || vel.z != 0.0f || vel.y > 0.0f || pos.y != std::floor(pos.y))
+                    return false;
+
+                const AABB entity = computeAABB(pos, box.halfExtents);
+                const int by = static_cast<int>(pos.y) - 1;
+
+                // Blocks strictly overlapping the footprint, the ones resolveAxis would push against
+                for (int bz = static_cast<int>(std::floor(entity.min.z)); static_cast<float>(bz) < entity.max.z; ++bz)
+                    for (int bx = static_cast<int>(std::floor(entity.min.x)); static_cast<float>(bx) < entity.max.x; ++bx)
+                        if (!this->world.isAir(bx, by, bz))
+                            return true;
+                return false;
+            }
+
             void update(Handler& handler, [[maybe_unused]] float dt) override
             {
-                auto view = handler.query<Position, Velocity, CollisionBox>();
+                auto view = handler.query<Position, Velocity, CollisionBox, optional<const TickLod>>();
+                auto& positions = handler.getPool<Position>();
 
-                view.forEach([&]([[maybe_unused]] EntityId id, Position& pos, Velocity& vel, CollisionBox& box)
+                // Entities only read the world and write their own components, so they're resolved in parallel
+                view.parallelForEach(this->world.getJobSystem(), [&](const EntityId id, Position& pos, Velocity& vel, CollisionBox& box, const TickLod* lod)
                 {
+                    const std::uint8_t steps = getTickSteps(lod);
+
+                    if (steps == 0)
+                        return;
+
+                    this->resolutions.fetch_add(1, std::memory_order_relaxed);
+
+                    // Resting entities skip the resolution, it would only cancel the gravity pull
+                    const ChangeTicks* ticks = positions.tryGetTicks(id);
+                    if (this->isResting(pos, vel, box, !ticks || isNewerTick(ticks->changed, this->getLastRunTick()))) {
+                        this->resting.fetch_add(1, std::memory_order_relaxed);
+                        vel.y = 0.0f;
+                        return;
+                    }
+
                     const glm::vec3& halfExt = box.halfExtents;
+                    const glm::vec3 before = pos;
+
+                    // Entities catching up on several ticks move steps times their velocity, split so no move exceeds MAX_CATCH_UP_MOVE
+                    const float longest = glm::max(glm::abs(vel.x), glm::max(glm::abs(vel.y), glm::abs(vel.z))) * static_cast<float>(steps);
+                    const int moves = glm::clamp(static_cast<int>(std::ceil(longest / MAX_CATCH_UP_MOVE)), 1, static_cast<int>(steps));
+                    const float scale = static_cast<float>(steps) / static_cast<float>(moves);
 
-                    const bool wasGoingDown = vel.y < 0.0f;
-                    const float preY = pos.y;
+                    for (int move = 0; move < moves; move++) {
+                        const bool wasGoingDown = vel.y < 0.0f;
+                        const float preY = pos.y;
 
-                    pos.y += vel.y;
-                    const bool hitY = resolveAxis(pos, vel, halfExt, 1, preY);
+                        pos.y += vel.y * scale;
+                        const bool hitY = resolveAxis(pos, vel, halfExt, 1, preY);
 
-                    pos.x += vel.x;
-                    resolveAxis(pos, vel, halfExt, 0);
+                        pos.x += vel.x * scale;
+                        resolveAxis(pos, vel, halfExt, 0);
 
-                    pos.z += vel.z;
-                    resolveAxis(pos, vel, halfExt, 2);
+                        pos.z += vel.z * scale;
+                        resolveAxis(pos, vel, halfExt, 2);
 
-                    box.isGrounded = wasGoingDown && hitY;
+                        box.isGrounded = wasGoingDown && hitY;
+                    }
+
+                    // Grounded idle entities get pushed back to the same height every tick, they don't count as moved
+                    if (static_cast<const glm::vec3&>(pos) != before)
+                        positions.markChanged(id);
                 });
             }
+
+            [[nodiscard]] CollisionStats getStats() const
+            {
+                return {this->resolutions.load(std::memory_order_relaxed), this->resting.load(std::memory_order_relaxed)};
+            }
     };
 }
 
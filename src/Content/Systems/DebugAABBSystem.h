@@ -117,7 +117,7 @@ namespace ECS
         // DEBUG - Renders AABB wireframe for every entity with Position + CollisionBox
         void render(Handler& handler) override
         {
-            auto view = handler.query<Position, CollisionBox>();
+            auto view = handler.query<const Position, const CollisionBox>();
 
             this->shader.use();
 
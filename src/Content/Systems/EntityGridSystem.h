@@ -0,0 +1,78 @@
+#ifndef FARFIELD_ENTITYGRIDSYSTEM_H
+#define FARFIELD_ENTITYGRIDSYSTEM_H
+
+#pragma once
+
+class World;
+
+#include "World.h"
+#include "ECS/ISystem.h"
+#include "CollisionSystem.h"
+#include "Components/Movements.h"
+#include "Components/CollisionBox.h"
+#include "Components/EntityGrid.h"
+
+namespace ECS
+{
+    // Rebuilds the world's entity grid from the boxes CollisionSystem just resolved,
+    // the grid is kept when no box moved, turned, appeared or went away since the previous update
+    class EntityGridSystem : public ISystem
+    {
+        World& world;
+
+        // Owner counts at the previous update, entities losing a component only show up here
+        std::size_t positionCount = 0;
+        std::size_t boxCount = 0;
+        std::size_t rotationCount = 0;
+
+        // Whether any box differs from the grid built on the previous update, added components count as changed
+        bool hasBoxChanges(Handler& handler)
+        {
+            const std::size_t positions = handler.getPool<Position>().size();
+            const std::size_t boxes = handler.getPool<CollisionBox>().size();
+            const std::size_t rotations = handler.getPool<Rotation>().size();
+            const ChangeTick since = this->getLastRunTick();
+            bool dirty = positions != this->positionCount || boxes != this->boxCount || rotations != this->rotationCount;
+
+            this->positionCount = positions;
+            this->boxCount = boxes;
+            this->rotationCount = rotations;
+
+            const auto found = [&](EntityId, auto&&...) { dirty = true; };
+
+            if (!dirty)
+                handler.query<changed<CollisionBox>>(since).forEach(found);
+            if (!dirty)
+                handler.query<changed<Position>, const CollisionBox>(since).forEach(found);
+            if (!dirty)
+                handler.query<changed<Rotation>, const CollisionBox>(since).forEach(found);
+            return dirty;
+        }
+
+        public:
+            using Access = ComponentAccess<const Position, const CollisionBox, optional<const Rotation>, EntityGrid>;
+
+            explicit EntityGridSystem(World& _world) : world(_world) {}
+
+            void update(Handler& handler, [[maybe_unused]] float dt) override
+            {
+                if (!this->hasBoxChanges(handler))
+                    return;
+
+                auto& grid = this->world.getEntityGrid();
+                auto view = handler.query<const Position, const CollisionBox, optional<const Rotation>>();
+
+                grid.clear();
+                view.forEach([&](const EntityId id, const Position& pos, const CollisionBox& box, const Rotation* rot)
+                {
+                    const glm::vec3 halfExt = computeRotatedHalfExtents(box.halfExtents, rot ? rot->y : 0.0f);
+                    const auto [min, max] = computeAABB(pos, halfExt);
+
+                    grid.insert(id, min, max);
+                });
+                grid.build();
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef FARFIELD_ENTITYPUSHSYSTEM_H
+#define FARFIELD_ENTITYPUSHSYSTEM_H
+
+#pragma once
+
+class World;
+
+#include "World.h"
+#include "ECS/ISystem.h"
+#include "CollisionSystem.h"
+#include "Components/Movements.h"
+#include "Components/CollisionBox.h"
+#include "Components/Friction.h"
+#include "Components/TickLod.h"
+#include "Components/EntityGrid.h"
+
+namespace ECS
+{
+    // Pushes overlapping entities apart horizontally, using the entity grid built at the end of the last tick.
+    // Only entities with friction are pushed, the others would keep the impulse forever
+    class EntityPushSystem : public ISystem
+    {
+        static constexpr float PUSH_STRENGTH = 0.02f;
+        static constexpr float MAX_PUSH = 0.05f;
+
+        World& world;
+
+        public:
+            using Access = ComponentAccess<const Position, Velocity, const CollisionBox, const Friction, optional<const Rotation>, optional<const TickLod>, const EntityGrid>;
+
+            explicit EntityPushSystem(World& _world) : world(_world) {}
+
+            void update(Handler& handler, [[maybe_unused]] float dt) override
+            {
+                const auto& grid = this->world.getEntityGrid();
+                auto view = handler.query<const Position, Velocity, const CollisionBox, const Friction, optional<const Rotation>, optional<const TickLod>>();
+
+                view.parallelForEach(this->world.getJobSystem(), [&](const EntityId id, const Position& pos, Velocity& vel, const CollisionBox& box, [[maybe_unused]] const Friction& friction, const Rotation* rot, const TickLod* lod)
+                {
+                    if (getTickSteps(lod) == 0)
+                        return;
+
+                    const glm::vec3 halfExt = computeRotatedHalfExtents(box.halfExtents, rot ? rot->y : 0.0f);
+                    const auto [min, max] = computeAABB(pos, halfExt);
+                    glm::vec2 push{0.f};
+
+                    grid.queryBox(min, max, [&](const SpatialHash::Entry& other) {
+                        if (other.id == id)
+                            return;
+
+                        const glm::vec2 otherCenter = (glm::vec2{other.min.x, other.min.z} + glm::vec2{other.max.x, other.max.z}) * 0.5f;
+                        glm::vec2 away = glm::vec2{pos.x, pos.z} - otherCenter;
+
+                        // Stacked on the same spot, split them along an id dependent direction
+                        if (glm::dot(away, away) < 1e-8f)
+                            away = id < other.id ? glm::vec2{1.f, 0.f} : glm::vec2{-1.f, 0.f};
+
+                        push += glm::normalize(away) * PUSH_STRENGTH;
+                    });
+
+                    const float length = glm::length(push);
+                    if (length > MAX_PUSH)
+                        push *= MAX_PUSH / length;
+
+                    vel.x += push.x;
+                    vel.z += push.y;
+                });
+            }
+    };
+}
+
+#endif
@@ -1,37 +1,47 @@
 #ifndef FARFIELD_FACINGSYSTEM_H
 #define FARFIELD_FACINGSYSTEM_H
 
-#include <cmath>
-#include <glm/glm.hpp>
-#include <glm/ext/scalar_constants.hpp>
+#include <vector>
 
 #include "ECS/ISystem.h"
 #include "Components/Movements.h"
 #include "Components/Camera.h"
+#include "Components/TickLod.h"
+#include "MovementKernels.h"
 
 namespace ECS
 {
     class FacingSystem : public ISystem
     {
         public:
+            using Access = ComponentAccess<const Velocity, Rotation, without<Camera>, optional<const TickLod>>;
+
             void update(Handler& handler, [[maybe_unused]] float dt) override
             {
-                auto view = handler.query<Velocity, Rotation>();
-                const auto& cameraPool = handler.getPool<Camera>();
+                auto view = handler.query<const Velocity, Rotation, without<Camera>, optional<const TickLod>>();
+                auto& rotations = handler.getPool<Rotation>();
 
-                view.forEach([&](const EntityId id, const Velocity& vel, Rotation& rot)
+                view.forEachChunk([&](const std::size_t count, const EntityId* ids, const Velocity* vel, Rotation* rot, const TickLod* lods)
                 {
-                    if (cameraPool.has(id))
-                        return;
+                    this->previousYaws.resize(count);
+                    for (std::size_t i = 0; i < count; i++)
+                        this->previousYaws[i] = rot[i].y;
 
-                    const float hSpeed = std::sqrt(vel.x * vel.x + vel.z * vel.z);
-                    if (hSpeed < 0.0001f)
-                        return;
+                    if (lods)
+                        this->kernels.faceVelocity(rot, vel, lods, count);
+                    else
+                        this->kernels.faceVelocity(rot, vel, count);
 
-                    const glm::vec3 dir = normalize(vel);
-                    rot.y = glm::degrees(std::atan2(dir.x, dir.z) + glm::pi<float>());
+                    // Entities keeping their heading don't count as changed, the entity grid skips its rebuild on them
+                    for (std::size_t i = 0; i < count; i++)
+                        if (rot[i].y != this->previousYaws[i])
+                            rotations.markChanged(ids[i]);
                 });
             }
+
+        private:
+            MovementKernels kernels;
+            std::vector<float> previousYaws; // Of the chunk being turned, kept across updates so it doesn't allocate
     };
 }
 
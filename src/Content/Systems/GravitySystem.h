@@ -5,26 +5,31 @@
 #include "Components/Movements.h"
 #include "Components/Gravity.h"
 #include "Components/CollisionBox.h"
+#include "Components/TickLod.h"
+#include "MovementKernels.h"
 
 namespace ECS
 {
     class GravitySystem : public ISystem
     {
         public:
+            using Access = ComponentAccess<Velocity, const Gravity, const CollisionBox, optional<const TickLod>>;
+
             void update(Handler& handler, [[maybe_unused]] float dt) override
             {
-                auto view = handler.query<Velocity, Gravity, CollisionBox>();
+                auto view = handler.query<Velocity, const Gravity, const CollisionBox, optional<const TickLod>>();
 
-                view.forEach([&]([[maybe_unused]] EntityId id, Velocity& vel, const Gravity& gravity, const CollisionBox& box)
+                view.forEachChunk([&](const std::size_t count, [[maybe_unused]] const EntityId* ids, Velocity* vel, const Gravity* gravity, const CollisionBox* boxes, const TickLod* lods)
                 {
-                    if (box.isGrounded)
-                          vel.y = -gravity.strength;
-                    else {
-                          vel.y -= gravity.strength;
-                          vel.y = glm::max(vel.y, gravity.terminalVelocity);
-                    }
+                    if (lods)
+                        this->kernels.applyGravity(vel, gravity, boxes, lods, count);
+                    else
+                        this->kernels.applyGravity(vel, gravity, boxes, count);
                 });
             }
+
+        private:
+            MovementKernels kernels;
     };
 }
 
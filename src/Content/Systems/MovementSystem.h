@@ -4,25 +4,37 @@
 #include "ECS/ISystem.h"
 #include "Components/Movements.h"
 #include "Components/CollisionBox.h"
+#include "Components/TickLod.h"
+#include "MovementKernels.h"
 
 namespace ECS
 {
     class MovementSystem : public ISystem
     {
         public:
+            using Access = ComponentAccess<Position, const Velocity, without<CollisionBox>, optional<const TickLod>>;
+
             void update(Handler& handler, [[maybe_unused]] float dt) override
             {
-                auto view = handler.query<Position, Velocity>();
-                const auto& boxPool = handler.getPool<CollisionBox>();
+                // Entities with a collision box are moved by the CollisionSystem
+                auto view = handler.query<Position, const Velocity, without<CollisionBox>, optional<const TickLod>>();
+                auto& positions = handler.getPool<Position>();
 
-                view.forEach([&](const EntityId id, Position& pos, const Velocity& vel)
+                view.forEachChunk([&](const std::size_t count, const EntityId* ids, Position* pos, const Velocity* vel, const TickLod* lods)
                 {
-                    if (boxPool.has(id))
-                        return;
+                    if (lods)
+                        this->kernels.integrate(pos, vel, lods, count);
+                    else
+                        this->kernels.integrate(pos, vel, count);
 
-                    pos += static_cast<const glm::vec3&>(vel);
+                    for (std::size_t i = 0; i < count; i++)
+                        if ((!lods || lods[i].steps > 0) && (vel[i].x != 0.0f || vel[i].y != 0.0f || vel[i].z != 0.0f))
+                            positions.markChanged(ids[i]);
                 });
             }
+
+        private:
+            MovementKernels kernels;
     };
 }
 
@@ -16,11 +16,13 @@ namespace ECS
         const InputState& inputs;
 
         public:
+            using Access = ComponentAccess<PlayerInput, const CollisionBox>;
+
             explicit PlayerInputSystem(const InputState& _inputs) : inputs(_inputs) {}
 
             void update(Handler &handler, [[maybe_unused]] float deltaTime) override
             {
-                auto view = handler.query<PlayerInput, CollisionBox>();
+                auto view = handler.query<PlayerInput, const CollisionBox>();
 
                 view.forEach([&]([[maybe_unused]] EntityId id, PlayerInput& playerInput, [[maybe_unused]] const CollisionBox& box)
                 {
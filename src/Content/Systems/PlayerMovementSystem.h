@@ -18,16 +18,17 @@ namespace ECS
         static constexpr float JUMP_FORCE   = 0.136f;
 
         public:
+            using Access = ComponentAccess<PlayerInput, const Camera, Velocity, const CollisionBox, optional<const Friction>>;
+
             void update(Handler &handler, [[maybe_unused]] float deltaTime) override
             {
-                auto view = handler.query<PlayerInput, Camera, Velocity, CollisionBox>();
-                auto& frictionPool = handler.getPool<Friction>();
+                auto view = handler.query<PlayerInput, const Camera, Velocity, const CollisionBox, optional<const Friction>>();
 
-                view.forEach([&]([[maybe_unused]] const EntityId id, PlayerInput& input, const Camera& camera, Velocity& vel, const CollisionBox& box) {
+                view.forEach([&]([[maybe_unused]] const EntityId id, PlayerInput& input, const Camera& camera, Velocity& vel, const CollisionBox& box, const Friction* frictions) {
                     float friction = 0.8f;
 
-                    if (frictionPool.has(id)) {
-                        const auto&[ground, air] = frictionPool.get(id);
+                    if (frictions) {
+                        const auto&[ground, air] = *frictions;
                         friction = box.isGrounded ? ground : air;
                     }
 
@@ -1,27 +1,113 @@
 #ifndef FARFIELD_RENDERSYSTEM_H
 #define FARFIELD_RENDERSYSTEM_H
 
+#include <algorithm>
+#include <vector>
+
 #include "Shader.h"
+#include "InstanceBuffer.h"
+#include "World.h"
 #include "EntityMeshData.h"
 #include "ItemRegistry.h"
 #include "ItemMeshRegistry.h"
 #include "ECS/ISystem.h"
 #include "Components/Movements.h"
 #include "Components/MeshRef.h"
+#include "Components/CollisionBox.h"
 #include "Components/Inventory.h"
 
 namespace ECS
 {
+    // Draws entities and held items instanced: one draw per mesh, the model matrices and texture layers
+    // of every visible instance uploaded once per frame to the instance buffer the shaders read.
+    // Entities past the render distance, in chunks that aren't ready or outside the chunk manager frustum are skipped
     class RenderSystem : public IRenderSystem
     {
+        // Instances of a mesh, back to back in the instance buffer from first on
+        struct InstanceGroup
+        {
+            const EntityMeshData* mesh = nullptr;
+            std::vector<EntityInstance> instances;
+            GLuint first = 0;
+        };
+
+        // Box around the entity position holding the mesh of entities without a CollisionBox
+        static constexpr glm::vec3 BOUNDS_MIN{-1.0f, 0.0f, -1.0f};
+        static constexpr glm::vec3 BOUNDS_MAX{1.0f, 2.5f, 1.0f};
+        // Meshes and held items reach past the collision box, arms included
+        static constexpr float BOX_MARGIN = 0.75f;
+        static constexpr GLuint INSTANCES_BINDING = 1; // Shader storage binding of the shaders Instances buffer
+
+        World& world;
         const ItemRegistry& itemRegistry;
         const ItemMeshRegistry& itemMeshRegistry;
         const EntityId& playerId;
+        float renderDistance;
 
         Shader shader;
         Shader itemShader;
 
-        bool renderRightHandItem(const EntityId& id, const ItemStack& rightHandStack, const Position& pos, const Rotation& rot)
+        // Kept across frames so their storage is reused
+        std::vector<InstanceGroup> entityGroups;
+        std::vector<InstanceGroup> itemGroups;
+        std::vector<EntityInstance> instanceData;
+        InstanceBuffer instanceBuffer{INSTANCES_BINDING};
+
+        // Few mesh types, a linear search beats hashing
+        static void addInstance(std::vector<InstanceGroup>& groups, const EntityMeshData* mesh, const glm::mat4& model, const std::uint32_t layer)
+        {
+            auto it = std::ranges::find(groups, mesh, &InstanceGroup::mesh);
+
+            if (it == groups.end())
+                it = groups.insert(groups.end(), InstanceGroup{mesh, {}, 0});
+            it->instances.push_back(EntityInstance{model, layer, 0, 0, 0});
+        }
+
+        // Groups of meshes no entity used last frame are dropped, their mesh may be gone
+        static void resetGroups(std::vector<InstanceGroup>& groups)
+        {
+            std::erase_if(groups, [](const InstanceGroup& group) { return group.instances.empty(); });
+
+            for (auto& group : groups)
+                group.instances.clear();
+        }
+
+        void packGroups(std::vector<InstanceGroup>& groups)
+        {
+            for (auto& group : groups) {
+                group.first = static_cast<GLuint>(this->instanceData.size());
+                this->instanceData.insert(this->instanceData.end(), group.instances.begin(), group.instances.end());
+            }
+        }
+
+        static void drawGroups(const std::vector<InstanceGroup>& groups)
+        {
+            for (const auto& group : groups)
+                if (!group.instances.empty())
+                    group.mesh->renderInstanced(static_cast<GLsizei>(group.instances.size()), group.first);
+        }
+
+        static bool hasInstances(const std::vector<InstanceGroup>& groups)
+        {
+            return std::ranges::any_of(groups, [](const InstanceGroup& group) { return !group.instances.empty(); });
+        }
+
+        // Collision box grown to hold the mesh whatever its yaw, the fixed bounds without one
+        static std::pair<glm::vec3, glm::vec3> computeBounds(const Position& pos, const CollisionBox* box)
+        {
+            const glm::vec3 origin = pos;
+
+            if (!box)
+                return {origin + BOUNDS_MIN, origin + BOUNDS_MAX};
+
+            const float horizontal = std::max(box->halfExtents.x, box->halfExtents.z) + BOX_MARGIN;
+            return {
+                origin + glm::vec3{-horizontal, -BOX_MARGIN, -horizontal},
+                origin + glm::vec3{horizontal, box->halfExtents.y * 2.0f + BOX_MARGIN, horizontal}
+            };
+        }
+
+        bool addRightHandItem(const EntityId& id, const ItemStack& rightHandStack, const Position& pos, const Rotation& rot)
         {
             if (rightHandStack.stackSize == 0)
                 return false;
@@ -36,22 +122,18 @@ namespace ECS
             model = glm::translate(model, {-0.35f, -0.25f, -0.4f});                                      // hand offset from eye
             model = glm::scale(model, glm::vec3{0.5f});
 
-            this->itemShader.use();
-            this->itemShader.setModelMatrix(model);
-            this->itemShader.setUniformUInt("LayerId", item.getTextureId());
-
-            glDisable(GL_CULL_FACE);
-            itemMesh->render();
-            glEnable(GL_CULL_FACE);
+            addInstance(this->itemGroups, itemMesh.get(), model, item.getTextureId());
 
             return id == this->playerId;
         }
 
         public:
-            explicit RenderSystem(const ItemRegistry& _itemRegistry, const ItemMeshRegistry& _itemMeshRegistry, const EntityId& _playerId) :
+            explicit RenderSystem(World& _world, const ItemRegistry& _itemRegistry, const ItemMeshRegistry& _itemMeshRegistry, const EntityId& _playerId, const float _renderDistance) :
+                world(_world),
                 itemRegistry(_itemRegistry),
                 itemMeshRegistry(_itemMeshRegistry),
                 playerId(_playerId),
+                renderDistance(_renderDistance),
                 shader("Entity/"),
                 itemShader("Item/")
             {
@@ -73,41 +155,84 @@ namespace ECS
 
             void render(Handler& handler) override
             {
-                auto view = handler.query<Position, Rotation, MeshRef>();
-                const auto& equipmentsPool = handler.getPool<Equipments>();
-                const auto& hotbarPool = handler.getPool<Hotbar>();
+                auto view = handler.query<const Position, const Rotation, const MeshRef, optional<const CollisionBox>, optional<const Hotbar>, optional<const Equipments>>();
+
+                // Frustum of the last World::update, same as the chunks drawn this frame
+                const Frustum& frustum = this->world.getChunkManager().getFrustum();
+                const glm::vec3 center = handler.getComponent<Position>(this->world.getPlayerEntity());
+                const float maxDistance2 = this->renderDistance * this->renderDistance;
 
-                view.forEach([&](const EntityId id, const Position& pos, const Rotation& rot, const MeshRef& meshRef)
+                resetGroups(this->entityGroups);
+                resetGroups(this->itemGroups);
+
+                view.forEach([&](const EntityId id, const Position& pos, const Rotation& rot, const MeshRef& meshRef, const CollisionBox* box, const Hotbar* hotbar, const Equipments* equipments)
                 {
+                    // Skip far entities
+                    const glm::vec3 offset = static_cast<const glm::vec3&>(pos) - center;
+                    if (glm::dot(offset, offset) > maxDistance2)
+                        return;
+
+                    // Skip entities outside the camera frustum, held item included
+                    const auto [min, max] = computeBounds(pos, box);
+                    if (!frustum.isBoxVisible(min, max))
+                        return;
+
+                    // Skip entities in chunks not drawn yet
+                    if (!this->world.isInReadyChunk(pos))
+                        return;
+
                     ItemStack rightHandStack;
 
-                    if (hotbarPool.has(id)) {
-                        const auto&[items, selectedSlot] = hotbarPool.get(id);
+                    if (hotbar) {
+                        const auto&[items, selectedSlot] = *hotbar;
                         rightHandStack = items[selectedSlot];
                     }
-                    else if (equipmentsPool.has(id)) {
-                        const auto&[armor, rightHand] = equipmentsPool.get(id);
+                    else if (equipments) {
+                        const auto&[armor, rightHand] = *equipments;
                         rightHandStack = rightHand;
                     }
 
                     // TODO: set RightArm bone not visible instead of skipping
-                    // Render right hand item & skip base mesh render if player is holding an item
-                    if (this->renderRightHandItem(id, rightHandStack, pos, rot))
+                    // Add right hand item & skip base mesh if player is holding an item
+                    if (this->addRightHandItem(id, rightHandStack, pos, rot))
                         return;
 
                     // Skip if mesh doesn't exist
                     if (!meshRef.mesh)
                         return;
 
-                    // Render entity mesh
+                    // Add entity mesh
                     glm::mat4 model = glm::translate(glm::mat4(1.0f), pos);
                     model = glm::rotate(model, glm::radians(-rot.y), {0.0f, 1.0f, 0.0f});
 
-                    this->shader.use();
-                    this->shader.setModelMatrix(model);
-                    this->shader.setUniformUInt("LayerId", meshRef.texId);
-                    meshRef.mesh->render();
+                    addInstance(this->entityGroups, meshRef.mesh.get(), model, meshRef.texId);
                 });
+
+                // Upload every instance once, entities then items
+                this->instanceData.clear();
+                this->packGroups(this->entityGroups);
+                this->packGroups(this->itemGroups);
+
+                if (this->instanceData.empty())
+                    return;
+
+                this->instanceBuffer.upload(this->instanceData);
+                this->instanceBuffer.bind();
+
+                // Render entity meshes
+                if (hasInstances(this->entityGroups)) {
+                    this->shader.use();
+                    drawGroups(this->entityGroups);
+                }
+
+                // Render right hand items
+                if (hasInstances(this->itemGroups)) {
+                    this->itemShader.use();
+
+                    glDisable(GL_CULL_FACE);
+                    drawGroups(this->itemGroups);
+                    glEnable(GL_CULL_FACE);
+                }
             }
 
     };
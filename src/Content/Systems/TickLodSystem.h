@@ -0,0 +1,96 @@
+#ifndef FARFIELD_TICKLODSYSTEM_H
+#define FARFIELD_TICKLODSYSTEM_H
+
+#pragma once
+
+class World;
+
+#include <array>
+#include <cstdint>
+
+#include "World.h"
+#include "ECS/ISystem.h"
+#include "Components/Movements.h"
+#include "Components/TickLod.h"
+
+namespace ECS
+{
+    // Entity updates, summed over every tick since the start
+    struct TickLodStats
+    {
+        std::uint64_t ticks = 0;
+        std::uint64_t entityTicks = 0; // Entities with a TickLod, each would run every tick without it
+        std::uint64_t updates = 0;     // Of those, the ones that ran
+        std::uint64_t frozen = 0;
+    };
+
+    // Picks the tick rate of every TickLod entity from its distance to the player, runs first so the other systems see it.
+    // Levels are staggered by entity id, so entities of the same ring don't all run on the same tick
+    class TickLodSystem : public ISystem
+    {
+        // Entities only move back to a faster rate this far inside the ring, so ring edges don't flip every tick
+        static constexpr float HYSTERESIS = 4.f;
+
+        World& world;
+        std::array<float, TickLod::MAX_LEVEL> distances;
+        std::uint64_t tick = 0;
+        TickLodStats stats;
+
+        [[nodiscard]] std::uint8_t getLevel(const float distance, const std::uint8_t previous) const
+        {
+            std::uint8_t level = 0;
+
+            while (level < TickLod::MAX_LEVEL && distance >= this->distances[level])
+                level++;
+
+            if (previous != TickLod::FROZEN && previous > level && distance >= this->distances[previous - 1] - HYSTERESIS)
+                return previous;
+            return level;
+        }
+
+        public:
+            using Access = ComponentAccess<const Position, TickLod>;
+
+            explicit TickLodSystem(World& _world, const std::array<float, TickLod::MAX_LEVEL>& _distances) :
+                world(_world),
+                distances(_distances)
+            {}
+
+            void update(Handler& handler, [[maybe_unused]] float dt) override
+            {
+                const glm::vec3 center = handler.getComponent<Position>(this->world.getPlayerEntity());
+                auto view = handler.query<const Position, TickLod>();
+
+                view.forEach([&](const EntityId id, const Position& pos, TickLod& lod)
+                {
+                    this->stats.entityTicks++;
+
+                    if (!this->world.isInReadyChunk(pos)) {
+                        lod = {TickLod::FROZEN, 0, 0};
+                        this->stats.frozen++;
+                        return;
+                    }
+
+                    lod.level = this->getLevel(glm::length(glm::vec2{pos.x - center.x, pos.z - center.z}), lod.level);
+                    lod.pending++;
+
+                    // A slower level never makes an entity wait past its new period
+                    const std::uint32_t period = 1u << lod.level;
+                    const bool due = ((this->tick + id) & (period - 1)) == 0 || lod.pending >= period;
+
+                    lod.steps = due ? lod.pending : 0;
+                    if (due) {
+                        lod.pending = 0;
+                        this->stats.updates++;
+                    }
+                });
+
+                this->tick++;
+                this->stats.ticks++;
+            }
+
+            [[nodiscard]] const TickLodStats& getStats() const { return this->stats; }
+    };
+}
+
+#endif
\ No newline at end of file
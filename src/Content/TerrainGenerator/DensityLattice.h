@@ -0,0 +1,34 @@
+#ifndef FARFIELD_DENSITYLATTICE_H
+#define FARFIELD_DENSITYLATTICE_H
+
+#pragma once
+
+#include <array>
+
+#include "GenerationCache.h"
+#include "ChunkPos.h"
+
+// Coarse 3D density samples owned by one chunk, one every 4x8x4 blocks from its min corner.
+// Lattice points on the chunk's +x/+y/+z faces are owned by the neighbors and shared with them
+struct DensityLattice {
+    static constexpr int STEP_XZ = 4;
+    static constexpr int STEP_Y = 8;
+    static constexpr int SIZE_XZ = 16 / STEP_XZ;
+    static constexpr int SIZE_Y = 16 / STEP_Y;
+
+    std::array<float, SIZE_XZ * SIZE_Y * SIZE_XZ> samples{};
+
+    [[nodiscard]] float get(const int i, const int j, const int k) const
+    {
+        return this->samples[i + SIZE_XZ * (j + SIZE_Y * k)];
+    }
+
+    void set(const int i, const int j, const int k, const float value)
+    {
+        this->samples[i + SIZE_XZ * (j + SIZE_Y * k)] = value;
+    }
+};
+
+using LatticeCache = GenerationCache<ChunkPos, DensityLattice, ChunkPosHash>;
+
+#endif
@@ -1,111 +1,381 @@
 #include "TerrainGenerator.h"
 
-TerrainGenerator::TerrainGenerator(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry) :
+TerrainGenerator::TerrainGenerator(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry, const TerrainMode _mode) :
     blockRegistry{_blockRegistry},
     prefabRegistry{_prefabRegistry},
+    mode(_mode),
+    columnCache([this](const ColumnPos& pos, ColumnData& column) { this->computeColumn(pos, column); }),
+    latticeCache([this](const ChunkPos& pos, DensityLattice& lattice) { this->computeLattice(pos, lattice); }),
     stone(this->blockRegistry.getByName("core:stone")),
     dirt(this->blockRegistry.getByName("core:dirt")),
-    grass(this->blockRegistry.getByName("core:grass")),
     air(this->blockRegistry.getByName("core:air"))
 {
-    this->noise.SetFrequency(0.015);
+    this->densityNoise.SetFrequency(DENSITY_FREQUENCY);
+    this->temperatureNoise.SetFrequency(CLIMATE_FREQUENCY);
+    this->humidityNoise.SetFrequency(CLIMATE_FREQUENCY);
+    this->continentalnessNoise.SetFrequency(CONTINENTALNESS_FREQUENCY);
+
+    for (std::size_t i = 0; i < BIOMES.size(); i++) {
+        this->biomeBlocks[i] = {
+            this->blockRegistry.getByName(BIOMES[i].surface),
+            this->blockRegistry.getByName(BIOMES[i].filler)
+        };
+    }
+}
+
+void TerrainGenerator::computeColumn(const ColumnPos& pos, ColumnData& column) const
+{
+    BatchNoise::Grid2D samples;
+    this->noise.sampleGrid2D(pos.x * ColumnData::SIZE, pos.z * ColumnData::SIZE, samples);
+
+    column.minHeight = std::numeric_limits<int>::max();
+    column.maxHeight = std::numeric_limits<int>::min();
+
+    for (int z = 0; z < ColumnData::SIZE; z++) {
+        for (int x = 0; x < ColumnData::SIZE; x++) {
+            const int height = BASE_HEIGHT + static_cast<int>(samples[x + z * ColumnData::SIZE] * AMPLITUDE);
+
+            column.heights[x + z * ColumnData::SIZE] = height;
+            column.minHeight = std::min(column.minHeight, height);
+            column.maxHeight = std::max(column.maxHeight, height);
+        }
+    }
+
+    this->computeBiomes(pos, column);
+}
+
+void TerrainGenerator::computeBiomes(const ColumnPos& pos, ColumnData& column) const
+{
+    // Corners of the coarse cells, the last row/column overlaps the next column's first one
+    std::array<Climate, CLIMATE_SIZE * CLIMATE_SIZE> samples;
+
+    for (int k = 0; k < CLIMATE_SIZE; k++) {
+        for (int i = 0; i < CLIMATE_SIZE; i++) {
+            const auto wx = static_cast<float>(pos.x * ColumnData::SIZE + i * CLIMATE_STEP);
+            const auto wz = static_cast<float>(pos.z * ColumnData::SIZE + k * CLIMATE_STEP);
+
+            samples[i + k * CLIMATE_SIZE] = {
+                this->temperatureNoise.GetNoise(wx, wz),
+                this->humidityNoise.GetNoise(wx, wz),
+                this->continentalnessNoise.GetNoise(wx, wz)
+            };
+        }
+    }
+
+    // Plain lerp, std::lerp's exactness guarantees cost more than the whole lookup here
+    const auto blend = [](const Climate& a, const Climate& b, const float t) -> Climate {
+        return {
+            a.temperature + (b.temperature - a.temperature) * t,
+            a.humidity + (b.humidity - a.humidity) * t,
+            a.continentalness + (b.continentalness - a.continentalness) * t
+        };
+    };
+
+    // Cells whose corners agree keep that biome, the others pick it per block from the blended climate
+    // so borders follow the climate instead of the coarse grid
+    for (int k = 0; k < CLIMATE_SIZE - 1; k++) {
+        for (int i = 0; i < CLIMATE_SIZE - 1; i++) {
+            const Climate& c00 = samples[i + k * CLIMATE_SIZE];
+            const Climate& c10 = samples[i + 1 + k * CLIMATE_SIZE];
+            const Climate& c01 = samples[i + (k + 1) * CLIMATE_SIZE];
+            const Climate& c11 = samples[i + 1 + (k + 1) * CLIMATE_SIZE];
+
+            const BiomeId biome = selectBiome(c00);
+            const bool uniform = selectBiome(c10) == biome && selectBiome(c01) == biome && selectBiome(c11) == biome;
+
+            for (int dz = 0; dz < CLIMATE_STEP; dz++) {
+                const float fz = static_cast<float>(dz) / CLIMATE_STEP;
+                const Climate near = blend(c00, c01, fz);
+                const Climate far = blend(c10, c11, fz);
+
+                for (int dx = 0; dx < CLIMATE_STEP; dx++) {
+                    const int index = i * CLIMATE_STEP + dx + (k * CLIMATE_STEP + dz) * ColumnData::SIZE;
+                    const float fx = static_cast<float>(dx) / CLIMATE_STEP;
+
+                    column.biomes[index] = uniform ? biome : selectBiome(blend(near, far, fx));
+                }
+            }
+        }
+    }
 }
 
-int TerrainGenerator::getTerrainHeight(const int worldX, const int worldZ) const
+const TerrainGenerator::BiomeBlocks& TerrainGenerator::getBiomeBlocks(const BiomeId biome) const
 {
-    const float n = this->noise.GetNoise(static_cast<float>(worldX), static_cast<float>(worldZ));
-    return BASE_HEIGHT + static_cast<int>(n * AMPLITUDE);
+    return this->biomeBlocks[static_cast<std::size_t>(biome)];
+}
+
+void TerrainGenerator::retainChunk(const ChunkPos& pos)
+{
+    this->columnCache.retain({pos.x, pos.z});
+
+    if (this->mode == TerrainMode::DENSITY)
+        this->latticeCache.retain(pos);
+}
+
+void TerrainGenerator::releaseChunk(const ChunkPos& pos)
+{
+    this->columnCache.release({pos.x, pos.z});
+
+    if (this->mode == TerrainMode::DENSITY)
+        this->latticeCache.release(pos);
+}
+
+void TerrainGenerator::setNoiseBackend(const BatchNoise::Backend backend)
+{
+    this->noise.setBackend(backend);
+}
+
+void TerrainGenerator::buildPipeline(GenerationPipeline& pipeline) const
+{
+    pipeline
+        .addStage({"terrain", 0, 0, JobPriority::TERRAIN, [this](Chunk& chunk, NeighborAccess&) { this->generate(chunk); }})
+        .addStage({"decoration", 0, 1, JobPriority::DECORATION, [this](Chunk& chunk, NeighborAccess& neighbors) { this->decorate(chunk, neighbors); }});
+}
+
+TerrainGenerator::ChunkClass TerrainGenerator::classify(const int chunkY, const ColumnData& column)
+{
+    const int minY = chunkY * Chunk::SIZE;
+    const int maxY = minY + Chunk::SIZE - 1;
+
+    if (minY > column.maxHeight && minY >= STONE_DEPTH)
+        return ChunkClass::AIR;
+    // Biome filler blocks sit right under the surface, only the dirt below is uniform
+    if (maxY < column.minHeight - FILLER_DEPTH)
+        return ChunkClass::SOLID;
+    return ChunkClass::SURFACE;
 }
 
 void TerrainGenerator::generate(Chunk& chunk) const
 {
+    if (this->mode == TerrainMode::DENSITY) {
+        this->generateDensity(chunk);
+        return;
+    }
+
+    const auto [cx, cy, cz] = chunk.getPosition();
+    const auto column = this->columnCache.get({cx, cz});
+
+    // Uniform chunks are bulk filled, only the ones crossing the surface go block by block
+    switch (classify(cy, *column)) {
+        case ChunkClass::AIR:
+            chunk.fillDirect({0, 0, 0}, glm::ivec3(Chunk::SIZE - 1), Material::pack(this->air, 0));
+            break;
+        case ChunkClass::SOLID:
+            this->fillSolid(chunk);
+            break;
+        case ChunkClass::SURFACE:
+            this->fillSurface(chunk, *column);
+            break;
+    }
+}
+
+void TerrainGenerator::fillSolid(Chunk& chunk) const
+{
+    const int minY = chunk.getPosition().y * Chunk::SIZE;
+
+    chunk.fillDirect({0, 0, 0}, glm::ivec3(Chunk::SIZE - 1), Material::pack(this->dirt, 0));
+
+    if (minY < STONE_DEPTH)
+        chunk.fillDirect({0, 0, 0}, {Chunk::SIZE - 1, STONE_DEPTH - minY - 1, Chunk::SIZE - 1}, Material::pack(this->stone, 0));
+}
+
+void TerrainGenerator::fillSurface(Chunk& chunk, const ColumnData& column) const
+{
+    const int cy = chunk.getPosition().y;
+    std::array<Material, Chunk::SIZE> blocks;
+
     for (int x = 0; x < Chunk::SIZE; x++) {
         for (int z = 0; z < Chunk::SIZE; z++) {
-            const auto [cx, cy, cz] = chunk.getPosition();
-
-            const int wx = cx * Chunk::SIZE + x;
-            const int wz = cz * Chunk::SIZE + z;
-            const int height = this->getTerrainHeight(wx, wz);
+            const int height = column.getHeight(x, z);
+            const auto& [surface, filler] = this->getBiomeBlocks(column.getBiome(x, z));
 
             for (int y = 0; y < Chunk::SIZE; y++) {
                 const int wy = cy * Chunk::SIZE + y;
 
-                Material mat;
-                if (wy < 2)
-                    mat = Material::pack(this->stone, 0);
+                if (wy < STONE_DEPTH)
+                    blocks[y] = Material::pack(this->stone, 0);
+                else if (wy < height - FILLER_DEPTH)
+                    blocks[y] = Material::pack(this->dirt, 0);
                 else if (wy < height)
-                    mat = Material::pack(this->dirt, 0);
+                    blocks[y] = Material::pack(filler, 0);
                 else if (wy == height)
-                    mat = Material::pack(this->grass, 0);
+                    blocks[y] = Material::pack(surface, 0);
                 else
-                    mat = Material::pack(this->air, 0);
+                    blocks[y] = Material::pack(this->air, 0);
+            }
+
+            chunk.setColumnDirect(x, z, blocks);
+        }
+    }
+}
+
+float TerrainGenerator::sampleDensity(const int worldX, const int worldY, const int worldZ) const
+{
+    const float n = this->densityNoise.GetNoise(static_cast<float>(worldX), static_cast<float>(worldY), static_cast<float>(worldZ));
+    return n + static_cast<float>(BASE_HEIGHT - worldY) / DENSITY_SQUASH;
+}
 
-                chunk.setBlockDirect(x, y, z, mat);
+void TerrainGenerator::computeLattice(const ChunkPos& pos, DensityLattice& lattice) const
+{
+    for (int k = 0; k < DensityLattice::SIZE_XZ; k++) {
+        for (int j = 0; j < DensityLattice::SIZE_Y; j++) {
+            for (int i = 0; i < DensityLattice::SIZE_XZ; i++) {
+                lattice.set(i, j, k, this->sampleDensity(
+                    pos.x * Chunk::SIZE + i * DensityLattice::STEP_XZ,
+                    pos.y * Chunk::SIZE + j * DensityLattice::STEP_Y,
+                    pos.z * Chunk::SIZE + k * DensityLattice::STEP_XZ
+                ));
             }
         }
     }
 }
 
-void TerrainGenerator::decorate(const Chunk& chunk, NeighborAccess& neighbors) const
+void TerrainGenerator::generateDensity(Chunk& chunk) const
+{
+    constexpr int CX = DensityLattice::SIZE_XZ + 1;
+    constexpr int CY = DensityLattice::SIZE_Y + 1;
+    constexpr int HEIGHT = Chunk::SIZE + 1; // One extra layer to know what's above the top blocks
+
+    const ChunkPos pos = chunk.getPosition();
+    const int minY = pos.y * Chunk::SIZE;
+
+    // Gather the lattice corners, the far faces come from the +x/+y/+z neighbors' lattices
+    std::array<float, CX * CY * CX> corners{};
+    const auto corner = [&](const int i, const int j, const int k) -> float& {
+        return corners[i + CX * (j + CY * k)];
+    };
+
+    for (int dz = 0; dz <= 1; dz++) {
+        for (int dy = 0; dy <= 1; dy++) {
+            for (int dx = 0; dx <= 1; dx++) {
+                const auto lattice = this->latticeCache.get({pos.x + dx, pos.y + dy, pos.z + dz});
+
+                for (int k = 0; k < (dz ? 1 : DensityLattice::SIZE_XZ); k++)
+                    for (int j = 0; j < (dy ? 1 : DensityLattice::SIZE_Y); j++)
+                        for (int i = 0; i < (dx ? 1 : DensityLattice::SIZE_XZ); i++)
+                            corner(dx * DensityLattice::SIZE_XZ + i, dy * DensityLattice::SIZE_Y + j, dz * DensityLattice::SIZE_XZ + k) = lattice->get(i, j, k);
+            }
+        }
+    }
+
+    // Interpolated values are convex combinations of the corners, so the corners bound the whole chunk
+    const auto [lowest, highest] = std::ranges::minmax(corners);
+
+    if (highest <= 0 && minY >= STONE_DEPTH) {
+        chunk.fillDirect({0, 0, 0}, glm::ivec3(Chunk::SIZE - 1), Material::pack(this->air, 0));
+        return;
+    }
+    if (lowest > 0) {
+        this->fillSolid(chunk);
+        return;
+    }
+
+    const auto column = this->columnCache.get({pos.x, pos.z});
+    std::array<bool, Chunk::SIZE * HEIGHT * Chunk::SIZE> solid{};
+
+    for (int z = 0; z < Chunk::SIZE; z++) {
+        const int k = z / DensityLattice::STEP_XZ;
+        const float fz = static_cast<float>(z % DensityLattice::STEP_XZ) / DensityLattice::STEP_XZ;
+
+        for (int y = 0; y < HEIGHT; y++) {
+            const int j = std::min(y / DensityLattice::STEP_Y, DensityLattice::SIZE_Y - 1);
+            const float fy = static_cast<float>(y - j * DensityLattice::STEP_Y) / DensityLattice::STEP_Y;
+
+            for (int x = 0; x < Chunk::SIZE; x++) {
+                const int i = x / DensityLattice::STEP_XZ;
+                const float fx = static_cast<float>(x % DensityLattice::STEP_XZ) / DensityLattice::STEP_XZ;
+
+                const float d00 = std::lerp(corner(i, j, k), corner(i + 1, j, k), fx);
+                const float d10 = std::lerp(corner(i, j + 1, k), corner(i + 1, j + 1, k), fx);
+                const float d01 = std::lerp(corner(i, j, k + 1), corner(i + 1, j, k + 1), fx);
+                const float d11 = std::lerp(corner(i, j + 1, k + 1), corner(i + 1, j + 1, k + 1), fx);
+                const float density = std::lerp(std::lerp(d00, d10, fy), std::lerp(d01, d11, fy), fz);
+
+                solid[x + Chunk::SIZE * (y + HEIGHT * z)] = density > 0;
+            }
+        }
+    }
+
+    std::array<Material, Chunk::SIZE> blocks;
+
+    for (int z = 0; z < Chunk::SIZE; z++) {
+        for (int x = 0; x < Chunk::SIZE; x++) {
+            const Material surface = Material::pack(this->getBiomeBlocks(column->getBiome(x, z)).surface, 0);
+
+            for (int y = 0; y < Chunk::SIZE; y++) {
+                const int index = x + Chunk::SIZE * (y + HEIGHT * z);
+
+                if (minY + y < STONE_DEPTH)
+                    blocks[y] = Material::pack(this->stone, 0);
+                else if (!solid[index])
+                    blocks[y] = Material::pack(this->air, 0);
+                else if (solid[index + Chunk::SIZE])
+                    blocks[y] = Material::pack(this->dirt, 0);
+                else
+                    blocks[y] = surface;
+            }
+
+            chunk.setColumnDirect(x, z, blocks);
+        }
+    }
+}
+
+int TerrainGenerator::findGroundLevel(const Chunk& chunk, const GroundHeights& ground, const int lx, const int lz) const
 {
-    this->placePrefab(neighbors, "oak_tree_1", chunk.getPosition());
-    neighbors.markDirtyChunks();
+    const auto [cx, cy, cz] = chunk.getPosition();
+
+    if (this->mode == TerrainMode::HEIGHTMAP)
+        return this->columnCache.get({cx, cz})->getHeight(lx, lz);
+
+    // Density terrain can have several surfaces per column, use the highest one of this chunk
+    const int height = ground[lx + lz * Chunk::SIZE];
+    return height < 0 ? -1 : cy * Chunk::SIZE + height;
 }
 
-uint32_t TerrainGenerator::getDecorationSeed(const int chunkX, const int chunkZ) const
+void TerrainGenerator::decorate(const Chunk& chunk, NeighborAccess& neighbors) const
 {
-    return static_cast<uint32_t>(this->seed) ^
-           (static_cast<uint32_t>(chunkX) * 73856093u) ^
-           (static_cast<uint32_t>(chunkZ) * 19349663u);
+    // The chunk heightmaps follow the logs placed below, trees must root on the terrain only
+    GroundHeights ground{};
+
+    if (this->mode == TerrainMode::DENSITY)
+        for (int z = 0; z < Chunk::SIZE; z++)
+            for (int x = 0; x < Chunk::SIZE; x++)
+                ground[x + z * Chunk::SIZE] = static_cast<int8_t>(chunk.getHeight(HeightmapType::OPAQUE, x, z));
+
+    this->placePrefab(neighbors, "oak_tree_1", chunk, ground);
 }
 
-void TerrainGenerator::placePrefab(NeighborAccess& neighbors, const std::string& prefabName, const ChunkPos& pos) const
+void TerrainGenerator::placePrefab(NeighborAccess& neighbors, const std::string& prefabName, const Chunk& chunk, const GroundHeights& ground) const
 {
+    const ChunkPos pos = chunk.getPosition();
     const PrefabMeta& prefab = this->prefabRegistry.get(prefabName);
     const int chunkMinY = pos.y * Chunk::SIZE;
     const int chunkMaxY = chunkMinY + Chunk::SIZE - 1;
 
-    const uint32_t localSeed = this->getDecorationSeed(pos.x, pos.z);
-    std::mt19937 rng(localSeed);
-    std::uniform_int_distribution xDist(2, 13);
-    std::uniform_int_distribution zDist(2, 13);
-    std::uniform_int_distribution count(0, prefab.density);
-
-    const int maxInstance = count(rng);
+    // One stream per chunk and prefab, the same whatever order chunks get decorated in
+    auto rng = RandomUtils::stream(this->seed, pos.x, pos.y, pos.z, PREFAB_SALT + this->prefabRegistry.getByName(prefabName));
+    const int maxInstance = rng.nextInt(0, prefab.density);
+    const auto column = this->columnCache.get({pos.x, pos.z});
 
     for (int i = 0; i < maxInstance; i++) {
-        const int lx = xDist(rng);
-        const int lz = zDist(rng);
+        const int lx = rng.nextInt(2, 13);
+        const int lz = rng.nextInt(2, 13);
+        const int roll = rng.nextInt(0, 99);
+        const int rotation = rng.nextInt(0, PrefabMeta::ROTATIONS - 1);
         const int worldX = pos.x * 16 + lx;
         const int worldZ = pos.z * 16 + lz;
-        const int groundY = findGroundLevel(neighbors, worldX, worldZ);
+        // Neighbors may be decorating concurrently, the ground only comes from the terrain pass
+        const int groundY = this->findGroundLevel(chunk, ground, lx, lz);
 
         if (!(groundY >= chunkMinY && groundY <= chunkMaxY))
             continue;
-
-        const Material groundBlock = neighbors.getBlock(worldX, groundY, worldZ);
-
-        if (!this->blockRegistry.isEqual(groundBlock.getBlockId(), "core:grass"))
+        if (roll >= getBiome(column->getBiome(lx, lz)).treeChance)
             continue;
 
-        for (const auto& block : prefab.blocks) {
-            const int bx = worldX + block.x;
-            const int by = groundY + block.y + 1;
-            const int bz = worldZ + block.z;
-
-            const Material existing = neighbors.getBlock(bx, by, bz);
-
-            if (this->blockRegistry.isAir(existing.getBlockId()))
-                neighbors.setBlock(bx, by, bz, block.mat);
-        }
-    }
-}
+        if (chunk.getBlock(lx, groundY - chunkMinY, lz).getBlockId() != prefab.blockBelow)
+            continue;
 
-int TerrainGenerator::findGroundLevel(const NeighborAccess& neighbors, const int worldX, const int worldZ)
-{
-    for (int y = 128; y >= 0; y--) {
-        if (const Material mat = neighbors.getBlock(worldX, y, worldZ); mat.getBlockId() != 0)
-            return y;
+        for (const auto& [x, y, z, length, mat] : prefab.stamps[rotation].spans)
+            neighbors.placeSpan(worldX + x, groundY + y + 1, worldZ + z, length, mat);
     }
-    return -1;
 }
\ No newline at end of file
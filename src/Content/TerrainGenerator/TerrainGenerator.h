@@ -2,7 +2,7 @@
 #define FARFIELD_TERRAINGENERATOR_H
 
 #include <iostream>
-#include <random>
+#include <limits>
 
 #include <FastNoiseLite.h>
 #include <glm/glm.hpp>
@@ -10,36 +10,104 @@
 #include "BlockRegistry.h"
 #include "PrefabRegistry.h"
 #include "NeighborAccess.h"
+#include "GenerationPipeline.h"
+#include "ColumnCache.h"
+#include "BatchNoise.h"
+#include "DensityLattice.h"
+#include "Settings.h"
 #include "Chunk.h"
 #include "Utils.h"
+#include "RandomUtils.h"
 
 class TerrainGenerator
 {
     static constexpr int BASE_HEIGHT = 64;
     static constexpr float AMPLITUDE = 8.f;
+    static constexpr float FREQUENCY = 0.015f;
+    static constexpr int STONE_DEPTH = 2;
+    static constexpr int FILLER_DEPTH = 3; // Biome filler blocks under the surface, dirt below
+
+    // Climate is sampled every CLIMATE_STEP blocks and interpolated per block column.
+    // Budget: at most 5% of the terrain stage time, the samples are cached with the column
+    static constexpr int CLIMATE_STEP = 4;
+    static constexpr int CLIMATE_SIZE = ColumnData::SIZE / CLIMATE_STEP + 1;
+    static constexpr float CLIMATE_FREQUENCY = 0.003f;
+    static constexpr float CONTINENTALNESS_FREQUENCY = 0.0015f;
+
+    // Density mode, solid where noise + (BASE_HEIGHT - y) / DENSITY_SQUASH > 0
+    static constexpr float DENSITY_FREQUENCY = 0.02f;
+    static constexpr float DENSITY_SQUASH = 16.f;
 
     // Registries
     const BlockRegistry& blockRegistry;
     const PrefabRegistry& prefabRegistry;
 
+    const TerrainMode mode;
+
+    // Salts of the random streams, one per kind of feature
+    static constexpr uint64_t PREFAB_SALT = 0x100;
+
     // Seed & noise
     const int seed = 3120;
-    FastNoiseLite noise{seed};
+    BatchNoise noise{seed, FREQUENCY};
+    FastNoiseLite densityNoise{seed};
+    FastNoiseLite temperatureNoise{seed + 1};
+    FastNoiseLite humidityNoise{seed + 2};
+    FastNoiseLite continentalnessNoise{seed + 3};
+
+    // Height fields shared by the chunks stacked on a column
+    mutable ColumnCache columnCache;
+    // Density lattices, shared with the neighbors reading their faces
+    mutable LatticeCache latticeCache;
 
     // BlockId cache
     const BlockId stone;
     const BlockId dirt;
-    const BlockId grass;
     const BlockId air;
 
-    [[nodiscard]] int getTerrainHeight(int worldX, int worldZ) const;
-    [[nodiscard]] static int findGroundLevel(const NeighborAccess& neighbors, int worldX, int worldZ);
-    [[nodiscard]] uint32_t getDecorationSeed(int chunkX, int chunkZ) const;
+    struct BiomeBlocks {
+        BlockId surface;
+        BlockId filler;
+    };
+    std::array<BiomeBlocks, BIOMES.size()> biomeBlocks{};
+
+    void computeColumn(const ColumnPos& pos, ColumnData& column) const;
+    void computeBiomes(const ColumnPos& pos, ColumnData& column) const;
+    [[nodiscard]] const BiomeBlocks& getBiomeBlocks(BiomeId biome) const;
+
+    // Where a chunk sits relative to the surface of its column
+    enum class ChunkClass { AIR, SOLID, SURFACE };
+
+    [[nodiscard]] static ChunkClass classify(int chunkY, const ColumnData& column);
+    void fillSolid(Chunk& chunk) const;
+    void fillSurface(Chunk& chunk, const ColumnData& column) const;
 
-    void placePrefab(NeighborAccess& neighbors, const std::string& prefabName, const ChunkPos& pos) const;
+    void computeLattice(const ChunkPos& pos, DensityLattice& lattice) const;
+    void generateDensity(Chunk& chunk) const;
+
+    // Local Y of the highest opaque block of every column, taken before decoration writes to the chunk
+    using GroundHeights = std::array<int8_t, Chunk::SIZE * Chunk::SIZE>;
+
+    // Highest ground block of a column in the chunk (world Y), -1 when there is none
+    [[nodiscard]] int findGroundLevel(const Chunk& chunk, const GroundHeights& ground, int lx, int lz) const;
+
+    void placePrefab(NeighborAccess& neighbors, const std::string& prefabName, const Chunk& chunk, const GroundHeights& ground) const;
 
     public:
-        explicit TerrainGenerator(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry);
+        explicit TerrainGenerator(const BlockRegistry& _blockRegistry, const PrefabRegistry& _prefabRegistry, TerrainMode _mode);
+
+        // Keep the cached column and lattice of a chunk while it is loaded
+        void retainChunk(const ChunkPos& pos);
+        void releaseChunk(const ChunkPos& pos);
+
+        // Exact density at a block, what the lattice interpolates
+        [[nodiscard]] float sampleDensity(int worldX, int worldY, int worldZ) const;
+
+        // Forces a noise backend, mostly to compare them, unsupported ones fall back
+        void setNoiseBackend(BatchNoise::Backend backend);
+
+        // Registers the generation stages, in order, on the pipeline
+        void buildPipeline(GenerationPipeline& pipeline) const;
 
         void generate(Chunk& chunk) const;
         void decorate(const Chunk& chunk, NeighborAccess& neighbors) const;
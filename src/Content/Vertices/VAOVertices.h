@@ -50,6 +50,13 @@ struct EntityVertex {
     glm::vec2 uv;
 };
 
+// Per-instance data of instanced entity and item draws, std430 layout of the shaders Instances buffer
+struct EntityInstance {
+    glm::mat4 model;
+    uint32_t layer;
+    uint32_t _pad0, _pad1, _pad2;
+};
+
 struct MSDFVertex {
     glm::vec2 position;
     glm::vec2 uv;
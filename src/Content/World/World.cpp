@@ -9,6 +9,9 @@
 #include "Systems/FacingSystem.h"
 #include "Systems/MovementSystem.h"
 #include "Systems/CollisionSystem.h"
+#include "Systems/EntityPushSystem.h"
+#include "Systems/EntityGridSystem.h"
+#include "Systems/TickLodSystem.h"
 #include "Systems/DebugAABBSystem.h" // DEBUG - AABB outline renderer
 
 #include "Components/Movements.h"
@@ -19,11 +22,12 @@
 #include "Components/Friction.h"
 #include "ECS/EntityCreator.h"
 
-World::World(const Registries& _registries, const InputState& _inputs, const Settings& _settings) :
+World::World(const Registries& _registries, const InputState& _inputs, const Settings& _settings, JobSystem& _jobSystem) :
     registries(_registries),
     inputs(_inputs),
+    jobSystem(_jobSystem),
     shader("World/"),
-    chunkManager(_registries.blockRegistry, _registries.prefabRegistry, _settings),
+    chunkManager(_registries.blockRegistry, _registries.prefabRegistry, _settings, _jobSystem),
     meshManager(*this)
 {
     // Setup entity vector
@@ -34,14 +38,17 @@ World::World(const Registries& _registries, const InputState& _inputs, const Set
     this->entities.emplace_back(ECS::Creator::createZombie(this->ecs, *this));
 
     // Register ECS systems
+    this->scheduler.registerSystem<ECS::TickLodSystem>(*this, _settings.getEntityTickDistances()); // First, the systems after it read the tick rates
     this->scheduler.registerSystem<ECS::PlayerInputSystem>(this->inputs);
     this->scheduler.registerSystem<ECS::CameraSystem>(this->inputs);
     this->scheduler.registerSystem<ECS::GravitySystem>();
     this->scheduler.registerSystem<ECS::PlayerMovementSystem>();
     this->scheduler.registerSystem<ECS::FacingSystem>();
     this->scheduler.registerSystem<ECS::MovementSystem>();
+    this->scheduler.registerSystem<ECS::EntityPushSystem>(*this);
     this->scheduler.registerSystem<ECS::CollisionSystem>(*this);
-    this->scheduler.registerSystem<ECS::RenderSystem>(this->registries.itemRegistry, this->registries.itemMeshRegistry, this->player.id);
+    this->scheduler.registerSystem<ECS::EntityGridSystem>(*this); // Last, the push of the next tick reads this grid
+    this->scheduler.registerSystem<ECS::RenderSystem>(*this, this->registries.itemRegistry, this->registries.itemMeshRegistry, this->player.id, _settings.getEntityRenderDistance());
     // this->scheduler.registerSystem<ECS::DebugAABBSystem>();
 
     // Set WorldShader uniform to use loaded textures
@@ -82,6 +89,15 @@ bool World::isAir(const int wx, const int wy, const int wz)
     return this->registries.blockRegistry.isAir(this->getBlock(wx, wy, wz).getBlockId());
 }
 
+bool World::isInReadyChunk(const glm::vec3& pos)
+{
+    const glm::ivec3 block = glm::floor(pos);
+    const auto [cx, cy, cz] = ChunkPos::fromWorld(block.x, block.y, block.z);
+    const Chunk* chunk = this->chunkManager.getChunk(cx, cy, cz);
+
+    return chunk && chunk->getState() == ChunkState::READY;
+}
+
 void World::setBlock(const int wx, const int wy, const int wz, const Material mat)
 {
     const auto [cx, cy, cz] = ChunkPos::fromWorld(wx, wy, wz);
@@ -122,25 +138,30 @@ bool World::isEntityAt(const glm::ivec3 blockPos)
 
     bool found = false;
 
-    auto view = this->ecs.query<ECS::Position, ECS::CollisionBox>();
-    auto& rotPool = this->ecs.getPool<ECS::Rotation>();
-
-    view.forEach([&]([[maybe_unused]] ECS::EntityId id, const ECS::Position& pos, const ECS::CollisionBox& box) {
-        const float yaw = rotPool.has(id) ? rotPool.get(id).y : 0.0f;
-        const glm::vec3 halfExt = ECS::computeRotatedHalfExtents(box.halfExtents, yaw);
-        const ECS::AABB aabb = ECS::computeAABB(pos, halfExt);
-
-        if (blockMin.x < aabb.max.x && blockMax.x > aabb.min.x &&
-            blockMin.y < aabb.max.y && blockMax.y > aabb.min.y &&
-            blockMin.z < aabb.max.z && blockMax.z > aabb.min.z)
-        {
-            found = true;
-        }
+    // The grid holds the rotated boxes of the last tick
+    this->entityGrid.queryBox(blockMin, blockMax, [&](const SpatialHash::Entry&) {
+        found = true;
     });
 
     return found;
 }
 
+void World::spawnZombies(const std::size_t count, const float radius)
+{
+    // Golden angle spiral, even density over the disk and the same layout every run
+    constexpr float GOLDEN_ANGLE = 2.39996323f;
+
+    const glm::vec3 center = this->ecs.getComponent<ECS::Position>(this->player);
+    const std::size_t spawned = std::min(count, static_cast<std::size_t>(MAX_ENTITY) - 1 - this->entities.size());
+
+    for (std::size_t i = 0; i < spawned; i++) {
+        const float distance = radius * std::sqrt((static_cast<float>(i) + 0.5f) / static_cast<float>(spawned));
+        const float angle = static_cast<float>(i) * GOLDEN_ANGLE;
+        const ECS::Position position{center.x + distance * std::cos(angle), center.y, center.z + distance * std::sin(angle)};
+
+        this->entities.emplace_back(ECS::Creator::createZombie(this->ecs, *this, position));
+    }
+}
 
 // Update and render
 void World::update(const float aspect)
@@ -18,6 +18,8 @@
 #include "ItemRegistry.h"
 #include "Registries.h"
 #include "Settings.h"
+#include "JobSystem.h"
+#include "SpatialHash.h"
 #include "Shader.h"
 #include "ECS/ISystem.h"
 
@@ -28,13 +30,15 @@ class World {
 
     const Registries& registries;
     const InputState& inputs;
+    JobSystem& jobSystem;
 
     Shader shader;
     ChunkManager chunkManager;
     ChunkMeshManager meshManager;
 
     ECS::Handler ecs{MAX_ENTITY};
-    ECS::SystemScheduler scheduler{};
+    ECS::SystemScheduler scheduler{jobSystem};
+    SpatialHash entityGrid;
 
     std::vector<ECS::IEntity> entities{};
     ECS::IEntity player;
@@ -42,16 +46,18 @@ class World {
     bool isSimulationReady = false;
 
     public:
-        explicit World(const Registries& _registries, const InputState& _inputs, const Settings& _settings);
+        explicit World(const Registries& _registries, const InputState& _inputs, const Settings& _settings, JobSystem& _jobSystem);
 
         // Get ECS members
         ECS::Handler& getECS() { return this->ecs; }
         ECS::SystemScheduler& getECSScheduler() { return this->scheduler; }
         ECS::IEntity& getPlayerEntity() { return this->player; }
+        SpatialHash& getEntityGrid() { return this->entityGrid; }
 
         // Get other members
         const Registries& getRegistries() const { return this->registries; }
         ChunkManager& getChunkManager() { return this->chunkManager; }
+        JobSystem& getJobSystem() { return this->jobSystem; }
         Shader& getShader() { return this->shader; }
 
         // Lifecycle
@@ -62,6 +68,8 @@ class World {
         [[nodiscard]] Material getBlock(glm::ivec3 pos);
         [[nodiscard]] bool isAir(int wx, int wy, int wz);
         bool isEntityAt(glm::ivec3 blockPos);
+        void spawnZombies(std::size_t count, float radius); // Spread evenly over a disk around the player, capped by MAX_ENTITY
+        [[nodiscard]] bool isInReadyChunk(const glm::vec3& pos); // Entities elsewhere are neither ticked nor drawn
 
         // Updates
         void update(float aspect);
@@ -0,0 +1,608 @@
+#ifndef FARFIELD_ARCHETYPE_H
+#define FARFIELD_ARCHETYPE_H
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+#include "ECS/IEntity.h"
+#include "ECS/IComponent.h"
+
+// Archetype storage: entities sharing the same component set live in the same table,
+// split in fixed size chunks where every component type has its own contiguous column (SoA).
+// Queries walk the matching tables linearly instead of probing one sparse set per component
+namespace ECS
+{
+    inline static constexpr std::size_t MAX_COMPONENT_TYPES = 64;
+    inline static constexpr std::size_t ARCHETYPE_CHUNK_BYTES = 16 * 1024;
+
+    using Signature = std::bitset<MAX_COMPONENT_TYPES>;
+
+    // One component type inside a chunk, type erased so tables can be built at runtime
+    class IColumn
+    {
+        public:
+            std::vector<ChangeTicks> ticks;       // Parallel to the components
+            std::atomic<ChangeTick> newest = 0;   // Latest tick stamped in the column, lets tick filtered queries skip idle chunks
+
+            virtual ~IColumn() = default;
+
+            void stamp(const Index row, const ChangeTicks& value)
+            {
+                this->ticks[row] = value;
+                this->touch(value.changed);
+            }
+
+            // Writers of a stage all stamp the same tick, so racing markChanged calls agree on the value
+            void touch(const ChangeTick tick)
+            {
+                if (isNewerTick(tick, this->newest.load(std::memory_order_relaxed)))
+                    this->newest.store(tick, std::memory_order_relaxed);
+            }
+
+            // Moves row of another column of the same type to the back of this one
+            virtual void pushFrom(IColumn& source, Index row) = 0;
+            // Moves row of another column of the same type over a row of this one
+            virtual void assignFrom(Index target, IColumn& source, Index row) = 0;
+            virtual void popBack() = 0;
+
+            [[nodiscard]] virtual std::unique_ptr<IColumn> makeEmpty(std::size_t capacity) const = 0;
+            [[nodiscard]] virtual std::size_t getElementSize() const = 0;
+    };
+
+    template<typename T>
+    class Column : public IColumn
+    {
+        public:
+            std::vector<T> data;
+
+            void pushFrom(IColumn& source, const Index row) override
+            {
+                this->data.push_back(std::move(static_cast<Column&>(source).data[row]));
+                this->ticks.push_back(source.ticks[row]);
+                this->touch(source.ticks[row].changed);
+            }
+
+            void assignFrom(const Index target, IColumn& source, const Index row) override
+            {
+                this->data[target] = std::move(static_cast<Column&>(source).data[row]);
+                this->stamp(target, source.ticks[row]);
+            }
+
+            void popBack() override
+            {
+                this->data.pop_back();
+                this->ticks.pop_back();
+            }
+
+            [[nodiscard]] std::unique_ptr<IColumn> makeEmpty(const std::size_t capacity) const override
+            {
+                auto column = std::make_unique<Column>();
+                column->data.reserve(capacity);
+                column->ticks.reserve(capacity);
+                return column;
+            }
+
+            [[nodiscard]] std::size_t getElementSize() const override { return sizeof(T); }
+    };
+
+    struct ArchetypeChunk
+    {
+        std::vector<EntityId> entities;
+        std::vector<std::unique_ptr<IColumn>> columns; // Same order as Archetype::types
+
+        [[nodiscard]] std::size_t size() const { return this->entities.size(); }
+
+        template<typename T>
+        [[nodiscard]] T* getColumn(const std::int8_t column)
+        {
+            return static_cast<Column<T>*>(this->columns[column].get())->data.data();
+        }
+    };
+
+    struct Archetype
+    {
+        Signature signature;
+        std::vector<std::uint32_t> types;
+        std::array<std::int8_t, MAX_COMPONENT_TYPES> columnOf{}; // Column of a type id, -1 when absent
+        std::array<Index, MAX_COMPONENT_TYPES> addEdges{};       // Archetype reached by adding a type, filled on first use
+        std::array<Index, MAX_COMPONENT_TYPES> removeEdges{};    // Archetype reached by removing a type
+        std::vector<ArchetypeChunk> chunks;
+        std::size_t chunkCapacity = 1;
+        std::size_t count = 0;
+
+        [[nodiscard]] bool has(const std::uint32_t typeId) const { return this->signature.test(typeId); }
+    };
+
+    // Where an entity lives
+    struct EntityLocation
+    {
+        Index archetype = INVALID_INDEX;
+        Index chunk = 0;
+        Index row = 0;
+    };
+
+    class ArchetypeStorage
+    {
+        std::vector<std::unique_ptr<Archetype>> archetypes;
+        std::unordered_map<Signature, Index> archetypeIndex;
+        std::vector<EntityLocation> locations;
+        std::array<std::unique_ptr<IColumn>, MAX_COMPONENT_TYPES> prototypes; // Empty column of every known type
+        const ChangeTick* clock;
+
+        [[nodiscard]] ChangeTick now() const { return this->clock ? *this->clock : 0; }
+
+        template<typename T>
+        static std::uint32_t getTypeId()
+        {
+            const std::uint32_t typeId = ComponentTypeRegistry::getTypeId<T>();
+
+            if (typeId >= MAX_COMPONENT_TYPES)
+                throw std::runtime_error("[ECS::ArchetypeStorage::getTypeId] Too many component types");
+            return typeId;
+        }
+
+        Index getOrCreateArchetype(const Signature& signature)
+        {
+            if (const auto it = this->archetypeIndex.find(signature); it != this->archetypeIndex.end())
+                return it->second;
+
+            auto archetype = std::make_unique<Archetype>();
+            std::size_t rowSize = sizeof(EntityId);
+
+            archetype->signature = signature;
+            archetype->columnOf.fill(-1);
+            archetype->addEdges.fill(INVALID_INDEX);
+            archetype->removeEdges.fill(INVALID_INDEX);
+
+            for (std::uint32_t typeId = 0; typeId < MAX_COMPONENT_TYPES; typeId++) {
+                if (!signature.test(typeId))
+                    continue;
+
+                archetype->columnOf[typeId] = static_cast<std::int8_t>(archetype->types.size());
+                archetype->types.push_back(typeId);
+                rowSize += this->prototypes[typeId]->getElementSize();
+            }
+            archetype->chunkCapacity = std::max<std::size_t>(1, ARCHETYPE_CHUNK_BYTES / rowSize);
+
+            const auto index = static_cast<Index>(this->archetypes.size());
+            this->archetypes.push_back(std::move(archetype));
+            this->archetypeIndex.emplace(signature, index);
+            return index;
+        }
+
+        // Archetype with one type more or less, walking the cached edges first
+        Index getNeighborArchetype(const Index from, const std::uint32_t typeId, const bool add)
+        {
+            // Archetypes are heap allocated, the edge stays valid when the list grows
+            Archetype& archetype = *this->archetypes[from];
+            Index& edge = add ? archetype.addEdges[typeId] : archetype.removeEdges[typeId];
+
+            if (edge == INVALID_INDEX)
+                edge = this->getOrCreateArchetype(Signature{archetype.signature}.set(typeId, add));
+            return edge;
+        }
+
+        // Reserves a row at the back of an archetype, columns still have to be pushed.
+        // Every chunk before the last used one is full, at most one empty chunk is kept after it
+        EntityLocation appendRow(const Index archetypeIndex, const EntityId id)
+        {
+            Archetype& archetype = *this->archetypes[archetypeIndex];
+            const auto chunkIndex = static_cast<Index>(archetype.count / archetype.chunkCapacity);
+
+            if (chunkIndex == archetype.chunks.size()) {
+                ArchetypeChunk& chunk = archetype.chunks.emplace_back();
+
+                chunk.entities.reserve(archetype.chunkCapacity);
+                for (const std::uint32_t typeId : archetype.types)
+                    chunk.columns.push_back(this->prototypes[typeId]->makeEmpty(archetype.chunkCapacity));
+            }
+
+            ArchetypeChunk& chunk = archetype.chunks[chunkIndex];
+            const EntityLocation location{archetypeIndex, chunkIndex, static_cast<Index>(chunk.size())};
+
+            chunk.entities.push_back(id);
+            archetype.count++;
+            return location;
+        }
+
+        // Swaps the last row of the archetype into the removed one
+        void removeRow(const EntityLocation location)
+        {
+            Archetype& archetype = *this->archetypes[location.archetype];
+            const auto lastChunk = static_cast<Index>((archetype.count - 1) / archetype.chunkCapacity);
+            ArchetypeChunk& last = archetype.chunks[lastChunk];
+            ArchetypeChunk& chunk = archetype.chunks[location.chunk];
+            const auto lastRow = static_cast<Index>(last.size() - 1);
+
+            if (&chunk != &last || location.row != lastRow) {
+                const EntityId moved = last.entities[lastRow];
+
+                chunk.entities[location.row] = moved;
+                for (std::size_t c = 0; c < archetype.types.size(); c++)
+                    chunk.columns[c]->assignFrom(location.row, *last.columns[c], lastRow);
+
+                this->locations[moved] = location;
+            }
+
+            last.entities.pop_back();
+            for (const auto& column : last.columns)
+                column->popBack();
+
+            // Keep one empty chunk so entities passing through an archetype don't reallocate it each time
+            if (last.entities.empty() && archetype.chunks.size() > lastChunk + 1)
+                archetype.chunks.pop_back();
+            archetype.count--;
+        }
+
+        // Moves an entity to another archetype, carrying over the components both have
+        EntityLocation moveEntity(const EntityId id, const Index targetIndex)
+        {
+            const EntityLocation from = this->locations[id];
+            const EntityLocation to = this->appendRow(targetIndex, id);
+
+            Archetype& source = *this->archetypes[from.archetype];
+            Archetype& target = *this->archetypes[targetIndex];
+            ArchetypeChunk& sourceChunk = source.chunks[from.chunk];
+            ArchetypeChunk& targetChunk = target.chunks[to.chunk];
+
+            for (std::size_t c = 0; c < target.types.size(); c++) {
+                const std::int8_t sourceColumn = source.columnOf[target.types[c]];
+
+                if (sourceColumn >= 0)
+                    targetChunk.columns[c]->pushFrom(*sourceChunk.columns[sourceColumn], from.row);
+            }
+
+            this->removeRow(from);
+            this->locations[id] = to;
+            return to;
+        }
+
+        [[nodiscard]] const EntityLocation* find(const EntityId id) const
+        {
+            if (id >= this->locations.size() || this->locations[id].archetype == INVALID_INDEX)
+                return nullptr;
+            return &this->locations[id];
+        }
+
+        // Column holding T for an entity and its row, null when the entity doesn't own T
+        template<typename T>
+        IColumn* findColumn(const EntityId id, Index& row)
+        {
+            const EntityLocation* location = this->find(id);
+
+            if (!location)
+                return nullptr;
+
+            Archetype& archetype = *this->archetypes[location->archetype];
+            const std::int8_t column = archetype.columnOf[getTypeId<T>()];
+
+            if (column < 0)
+                return nullptr;
+
+            row = location->row;
+            return archetype.chunks[location->chunk].columns[column].get();
+        }
+
+    public:
+        explicit ArchetypeStorage(const std::size_t maxEntities = 0, const ChangeTick* _clock = nullptr) :
+            clock(_clock)
+        {
+            this->locations.reserve(maxEntities);
+            this->getOrCreateArchetype(Signature{});
+        }
+
+        void create(const EntityId id)
+        {
+            if (id >= this->locations.size())
+                this->locations.resize(id + 1);
+            this->locations[id] = this->appendRow(0, id);
+        }
+
+        void destroy(const EntityId id)
+        {
+            if (!this->find(id))
+                return;
+
+            this->removeRow(this->locations[id]);
+            this->locations[id] = EntityLocation{};
+        }
+
+        template<typename T>
+        T& add(const EntityId id, const T& component)
+        {
+            const std::uint32_t typeId = getTypeId<T>();
+
+            if (!this->prototypes[typeId])
+                this->prototypes[typeId] = std::make_unique<Column<T>>();
+
+            // Overwriting an owned component counts as a change
+            Index row = 0;
+            if (IColumn* existing = this->findColumn<T>(id, row)) {
+                existing->ticks[row].changed = this->now();
+                existing->touch(this->now());
+
+                T& value = static_cast<Column<T>*>(existing)->data[row];
+                value = component;
+                return value;
+            }
+
+            const EntityLocation to = this->moveEntity(id, this->getNeighborArchetype(this->locations[id].archetype, typeId, true));
+            Archetype& target = *this->archetypes[to.archetype];
+            auto& column = *static_cast<Column<T>*>(target.chunks[to.chunk].columns[target.columnOf[typeId]].get());
+
+            column.data.push_back(component);
+            column.ticks.emplace_back();
+            column.stamp(to.row, {this->now(), this->now()});
+            return column.data.back();
+        }
+
+        template<typename T>
+        void remove(const EntityId id)
+        {
+            if (!this->has<T>(id))
+                return;
+
+            this->moveEntity(id, this->getNeighborArchetype(this->locations[id].archetype, getTypeId<T>(), false));
+        }
+
+        template<typename T>
+        [[nodiscard]] bool has(const EntityId id) const
+        {
+            const EntityLocation* location = this->find(id);
+            return location && this->archetypes[location->archetype]->has(getTypeId<T>());
+        }
+
+        template<typename T>
+        T* tryGet(const EntityId id)
+        {
+            const EntityLocation* location = this->find(id);
+
+            if (!location)
+                return nullptr;
+
+            Archetype& archetype = *this->archetypes[location->archetype];
+            const std::int8_t column = archetype.columnOf[getTypeId<T>()];
+
+            if (column < 0)
+                return nullptr;
+            return &archetype.chunks[location->chunk].getColumn<T>(column)[location->row];
+        }
+
+        template<typename T>
+        T& get(const EntityId id)
+        {
+            return *this->tryGet<T>(id);
+        }
+
+        template<typename T>
+        [[nodiscard]] const ChangeTicks* tryGetTicks(const EntityId id)
+        {
+            Index row = 0;
+            const IColumn* column = this->findColumn<T>(id, row);
+            return column ? &column->ticks[row] : nullptr;
+        }
+
+        // Writes through get/tryGet aren't tracked, writers report them here for changed<T> queries
+        template<typename T>
+        void markChanged(const EntityId id)
+        {
+            Index row = 0;
+
+            if (IColumn* column = this->findColumn<T>(id, row)) {
+                column->ticks[row].changed = this->now();
+                column->touch(this->now());
+            }
+        }
+
+        // Entities owning a component
+        template<typename T>
+        [[nodiscard]] std::size_t count() const
+        {
+            const std::uint32_t typeId = getTypeId<T>();
+            std::size_t total = 0;
+
+            for (const auto& archetype : this->archetypes)
+                if (archetype->has(typeId))
+                    total += archetype->count;
+            return total;
+        }
+
+        // Query arguments as in ECS/Query.h, filtered per table then walked row by row
+        template<typename... Ts, typename Func>
+        void forEach(Func&& callback, const ChangeTick since = 0)
+        {
+            this->forEachMatchingChunk<Ts...>(since, [&](ArchetypeChunk& chunk, const auto& columns) {
+                forEachRow<Ts...>(chunk, columns, since, callback, std::index_sequence_for<Ts...>{});
+            });
+        }
+
+        // Same as forEach with one job per chunk, the callback must be thread safe
+        template<typename... Ts, typename Func>
+        void parallelForEach(JobSystem& jobSystem, Func&& callback, const ChangeTick since = 0)
+        {
+            using Columns = std::array<std::int8_t, sizeof...(Ts)>;
+            std::vector<std::pair<ArchetypeChunk*, Columns>> batches;
+
+            this->forEachMatchingChunk<Ts...>(since, [&](ArchetypeChunk& chunk, const Columns& columns) {
+                batches.emplace_back(&chunk, columns);
+            });
+
+            const ParallelCommandPass pass;
+
+            jobSystem.parallelFor(batches.size(), [&](const std::size_t batch) {
+                const CommandScope scope(pass.batch(batch));
+                forEachRow<Ts...>(*batches[batch].first, batches[batch].second, since, callback, std::index_sequence_for<Ts...>{});
+            });
+        }
+
+        // Whole chunks at once for batch kernels, see ECS/Query.h. An optional column is null when the chunk doesn't have it
+        template<typename... Ts, typename Func>
+        void forEachChunk(Func&& callback)
+        {
+            static_assert(!HAS_TICK_FILTER<Ts...>, "forEachChunk can't filter on changed<> or added<>");
+
+            this->forEachMatchingChunk<Ts...>(0, [&](ArchetypeChunk& chunk, const auto& columns) {
+                forwardChunk<Ts...>(chunk, columns, callback, std::index_sequence_for<Ts...>{});
+            });
+        }
+
+    private:
+        // Calls fn(chunk, columns) on every non empty chunk of the tables matching the query,
+        // columns[i] being the column of the i-th query argument, -1 when the table doesn't have it.
+        // Chunks where a changed<> or added<> column holds nothing newer than since are skipped
+        template<typename... Ts, typename Func>
+        void forEachMatchingChunk(const ChangeTick since, Func&& fn)
+        {
+            Signature required;
+            Signature excluded;
+            (addFilter<Ts>(required, excluded), ...);
+
+            for (const auto& archetype : this->archetypes) {
+                if ((archetype->signature & required) != required || (archetype->signature & excluded).any() || archetype->count == 0)
+                    continue;
+
+                const std::array<std::int8_t, sizeof...(Ts)> columns{archetype->columnOf[getTypeId<typename QueryArg<Ts>::Component>()]...};
+
+                for (auto& chunk : archetype->chunks)
+                    if (chunk.size() > 0 && mayHaveNewTicks<Ts...>(chunk, columns, since, std::index_sequence_for<Ts...>{}))
+                        fn(chunk, columns);
+            }
+        }
+
+        template<typename... Ts, std::size_t... I>
+        static bool mayHaveNewTicks(const ArchetypeChunk& chunk, const std::array<std::int8_t, sizeof...(Ts)>& columns, const ChangeTick since, std::index_sequence<I...>)
+        {
+            return ((!QueryArg<Ts>::TICK_FILTER || isNewerTick(chunk.columns[columns[I]]->newest.load(std::memory_order_relaxed), since)) && ...);
+        }
+
+        template<typename T>
+        static void addFilter(Signature& required, Signature& excluded)
+        {
+            if constexpr (QueryArg<T>::REQUIRED)
+                required.set(getTypeId<typename QueryArg<T>::Component>());
+            else if constexpr (QueryArg<T>::EXCLUDED)
+                excluded.set(getTypeId<typename QueryArg<T>::Component>());
+        }
+
+        // First element of a query argument's column, null when the table doesn't have it
+        template<typename T>
+        static typename QueryArg<T>::Pointer getColumnBase(ArchetypeChunk& chunk, const std::int8_t column)
+        {
+            if constexpr (QueryArg<T>::EXCLUDED)
+                return nullptr;
+            else if constexpr (QueryArg<T>::TICK_FILTER)
+                return chunk.columns[column]->ticks.data();
+            else
+                return column < 0 ? nullptr : chunk.getColumn<typename QueryArg<T>::Component>(column);
+        }
+
+        template<typename T>
+        static typename QueryArg<T>::Pointer getRow(const typename QueryArg<T>::Pointer base, const std::size_t row)
+        {
+            if constexpr (QueryArg<T>::REQUIRED)
+                return base + row;
+            else
+                return base ? base + row : nullptr;
+        }
+
+        template<typename... Ts, typename Func, std::size_t... I>
+        static void forEachRow(ArchetypeChunk& chunk, const std::array<std::int8_t, sizeof...(Ts)>& columns, [[maybe_unused]] const ChangeTick since, Func& callback, std::index_sequence<I...>)
+        {
+            const std::tuple<typename QueryArg<Ts>::Pointer...> bases{getColumnBase<Ts>(chunk, columns[I])...};
+            const EntityId* entities = chunk.entities.data();
+            const std::size_t size = chunk.size();
+
+            for (std::size_t row = 0; row < size; row++) {
+                // Table filters already hold for every row, only ticks differ
+                if constexpr (HAS_TICK_FILTER<Ts...>)
+                    if (!((!QueryArg<Ts>::TICK_FILTER || acceptsQueryArg<Ts>(getRow<Ts>(std::get<I>(bases), row), since)) && ...))
+                        continue;
+
+                std::apply(callback, std::tuple_cat(std::tuple<EntityId>{entities[row]}, QueryArg<Ts>::forward(getRow<Ts>(std::get<I>(bases), row))...));
+            }
+        }
+
+        template<typename... Ts, typename Func, std::size_t... I>
+        static void forwardChunk(ArchetypeChunk& chunk, const std::array<std::int8_t, sizeof...(Ts)>& columns, Func& callback, std::index_sequence<I...>)
+        {
+            std::apply(callback, std::tuple_cat(
+                std::tuple<std::size_t, const EntityId*>{chunk.size(), chunk.entities.data()},
+                QueryArg<Ts>::forwardColumn(getColumnBase<Ts>(chunk, columns[I]))...));
+        }
+    };
+
+    // Per type accessor, what Handler::getPool returns in archetype mode
+    template<typename T>
+    class ArchetypePool final : public IComponentPool
+    {
+        ArchetypeStorage& storage;
+
+        public:
+            explicit ArchetypePool(ArchetypeStorage& _storage) :
+                storage(_storage)
+            {}
+
+            T& add(const EntityId id, const T& component) { return this->storage.add<T>(id, component); }
+            T& get(const EntityId id) { return this->storage.get<T>(id); }
+            [[nodiscard]] const T& get(const EntityId id) const { return this->storage.get<T>(id); }
+            T* tryGet(const EntityId id) { return this->storage.tryGet<T>(id); }
+            [[nodiscard]] const ChangeTicks* tryGetTicks(const EntityId id) { return this->storage.tryGetTicks<T>(id); }
+            void markChanged(const EntityId id) { this->storage.markChanged<T>(id); }
+
+            void remove(const EntityId id) override { this->storage.remove<T>(id); }
+
+            void clear() override
+            {
+                std::vector<EntityId> owners;
+
+                this->storage.forEach<T>([&](const EntityId id, T&) { owners.push_back(id); });
+                for (const EntityId id : owners)
+                    this->storage.remove<T>(id);
+            }
+
+            [[nodiscard]] bool has(const EntityId id) const override { return this->storage.has<T>(id); }
+            [[nodiscard]] std::size_t size() const override { return this->storage.count<T>(); }
+    };
+
+    template<typename... Ts>
+    class ArchetypeView
+    {
+        ArchetypeStorage& storage;
+        ChangeTick since;
+
+        public:
+            explicit ArchetypeView(ArchetypeStorage& _storage, const ChangeTick _since = 0) :
+                storage(_storage),
+                since(_since)
+            {}
+
+            template<typename Func>
+            void forEach(Func&& callback)
+            {
+                this->storage.forEach<Ts...>(std::forward<Func>(callback), this->since);
+            }
+
+            template<typename Func>
+            void parallelForEach(JobSystem& jobSystem, Func&& callback)
+            {
+                this->storage.parallelForEach<Ts...>(jobSystem, std::forward<Func>(callback), this->since);
+            }
+
+            template<typename Func>
+            void forEachChunk(Func&& callback)
+            {
+                this->storage.forEachChunk<Ts...>(std::forward<Func>(callback));
+            }
+    };
+}
+
+#endif
\ No newline at end of file
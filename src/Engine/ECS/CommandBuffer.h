@@ -0,0 +1,300 @@
+#ifndef FARFIELD_COMMANDBUFFER_H
+#define FARFIELD_COMMANDBUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <compare>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ECS/IEntity.h"
+
+// Structural changes (create, destroy, add, remove) recorded while systems iterate, applied later in record order.
+// Commands live in blocks kept across flushes, so once warmed up recording doesn't allocate
+namespace ECS
+{
+    class Handler;
+
+    // Where a command was recorded: the system, the parallel pass of that system and the batch of the pass (0 outside one).
+    // Buffers belong to threads and which thread runs a batch is up to the scheduling, so commands are applied in key order
+    struct CommandKey
+    {
+        std::uint32_t system = 0;
+        std::uint32_t pass = 0;
+        std::uint32_t batch = 0;
+
+        auto operator<=>(const CommandKey&) const = default;
+
+        // Key of the commands the calling thread records
+        static CommandKey& current()
+        {
+            thread_local CommandKey key;
+            return key;
+        }
+    };
+
+    // Sets the key of the calling thread for its lifetime
+    class CommandScope
+    {
+        CommandKey previous;
+
+        public:
+            explicit CommandScope(const CommandKey key) :
+                previous(CommandKey::current())
+            {
+                CommandKey::current() = key;
+            }
+
+            ~CommandScope() { CommandKey::current() = this->previous; }
+
+            CommandScope(const CommandScope&) = delete;
+            CommandScope& operator=(const CommandScope&) = delete;
+    };
+
+    // Opened around a parallelForEach by the thread that calls it, the batches record under pass() and their index + 1.
+    // Commands recorded after it get a later pass, so they still apply after the batches
+    class ParallelCommandPass
+    {
+        CommandKey key;
+
+        public:
+            ParallelCommandPass() :
+                key(CommandKey::current())
+            {
+                this->key.pass++;
+                this->key.batch = 0;
+            }
+
+            ~ParallelCommandPass() { CommandKey::current().pass = this->key.pass + 1; }
+
+            ParallelCommandPass(const ParallelCommandPass&) = delete;
+            ParallelCommandPass& operator=(const ParallelCommandPass&) = delete;
+
+            [[nodiscard]] CommandKey batch(const std::size_t index) const
+            {
+                return {this->key.system, this->key.pass, static_cast<std::uint32_t>(index + 1)};
+            }
+    };
+
+    // Entity created by a buffer, only usable with that buffer until it's applied
+    struct PendingEntity
+    {
+        std::uint32_t index;
+    };
+
+    class CommandBuffer
+    {
+        static constexpr std::size_t BLOCK_SIZE = 16 * 1024;
+
+        using Apply = void(*)(Handler& handler, void* payload, std::vector<IEntity>& created);
+        using Destroy = void(*)(void* payload);
+
+        struct Command
+        {
+            Apply apply;
+            Destroy destroy; // Null for trivially destructible payloads
+            void* payload;
+            Command* next;
+            CommandKey key;
+        };
+
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            std::size_t capacity;
+            std::size_t used = 0;
+        };
+
+        // Either a live entity or one created earlier in the same buffer
+        struct Target
+        {
+            IEntity entity;
+            std::uint32_t pending = INVALID_INDEX;
+
+            [[nodiscard]] IEntity resolve(const std::vector<IEntity>& created) const
+            {
+                return this->pending == INVALID_INDEX ? this->entity : created[this->pending];
+            }
+        };
+
+        template<typename T>
+        struct AddCommand
+        {
+            Target target;
+            T component;
+        };
+
+        std::vector<Block> blocks;
+        std::size_t currentBlock = 0;
+        Command* head = nullptr;
+        Command* tail = nullptr;
+        std::size_t count = 0;
+        std::uint32_t pendingCount = 0;
+        std::vector<IEntity> created; // Entities of the create commands, by PendingEntity index
+
+        void* allocate(const std::size_t size, const std::size_t alignment)
+        {
+            while (true) {
+                if (this->currentBlock == this->blocks.size()) {
+                    const std::size_t capacity = std::max(BLOCK_SIZE, size + alignment);
+                    this->blocks.push_back({std::make_unique_for_overwrite<std::byte[]>(capacity), capacity});
+                }
+
+                Block& block = this->blocks[this->currentBlock];
+                void* ptr = block.data.get() + block.used;
+                std::size_t space = block.capacity - block.used;
+
+                if (std::align(alignment, size, ptr, space)) {
+                    block.used = block.capacity - space + size;
+                    return ptr;
+                }
+                this->currentBlock++;
+            }
+        }
+
+        template<typename P>
+        void push(const Apply apply, P&& payload)
+        {
+            using Payload = std::remove_cvref_t<P>;
+
+            auto* command = new (this->allocate(sizeof(Command), alignof(Command))) Command{apply, nullptr, nullptr, nullptr, CommandKey::current()};
+            command->payload = new (this->allocate(sizeof(Payload), alignof(Payload))) Payload(std::forward<P>(payload));
+
+            if constexpr (!std::is_trivially_destructible_v<Payload>)
+                command->destroy = [](void* ptr) { static_cast<Payload*>(ptr)->~Payload(); };
+
+            if (this->tail)
+                this->tail->next = command;
+            else
+                this->head = command;
+            this->tail = command;
+            this->count++;
+        }
+
+        // Handler is only complete once the commands get applied, H defers the lookups until then
+        // Creates of a buffer can run out of record order once merged with the other buffers, each fills its own slot
+        template<typename H = Handler>
+        static void applyCreate(H& handler, void* payload, std::vector<IEntity>& created)
+        {
+            created[static_cast<Target*>(payload)->pending] = handler.createEntity();
+        }
+
+        template<typename H = Handler>
+        static void applyDestroy(H& handler, void* payload, std::vector<IEntity>& created)
+        {
+            handler.destroyEntity(static_cast<Target*>(payload)->resolve(created));
+        }
+
+        template<typename T, typename H = Handler>
+        static void applyAdd(H& handler, void* payload, std::vector<IEntity>& created)
+        {
+            auto& command = *static_cast<AddCommand<T>*>(payload);
+            const IEntity entity = command.target.resolve(created);
+
+            if (handler.isAlive(entity))
+                handler.addComponent(entity, command.component);
+        }
+
+        template<typename T, typename H = Handler>
+        static void applyRemove(H& handler, void* payload, std::vector<IEntity>& created)
+        {
+            const IEntity entity = static_cast<Target*>(payload)->resolve(created);
+
+            if (handler.isAlive(entity))
+                handler.template removeComponent<T>(entity);
+        }
+
+        public:
+            // A command of one of the buffers merged by applyAll
+            struct Entry
+            {
+                CommandKey key;
+                CommandBuffer* buffer;
+                Command* command;
+            };
+
+            CommandBuffer() = default;
+            ~CommandBuffer() { this->clear(); }
+
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+            PendingEntity createEntity()
+            {
+                this->push(&applyCreate<>, Target{{}, this->pendingCount});
+                return {this->pendingCount++};
+            }
+
+            void destroyEntity(const IEntity entity) { this->push(&applyDestroy<>, Target{entity}); }
+            void destroyEntity(const PendingEntity entity) { this->push(&applyDestroy<>, Target{{}, entity.index}); }
+
+            // Adding to an entity destroyed in the meantime does nothing, same for removing
+            template<typename T>
+            void addComponent(const IEntity entity, const T& component)
+            {
+                this->push(&applyAdd<T>, AddCommand<T>{Target{entity}, component});
+            }
+
+            template<typename T>
+            void addComponent(const PendingEntity entity, const T& component)
+            {
+                this->push(&applyAdd<T>, AddCommand<T>{Target{{}, entity.index}, component});
+            }
+
+            template<typename T>
+            void removeComponent(const IEntity entity) { this->push(&applyRemove<T>, Target{entity}); }
+
+            template<typename T>
+            void removeComponent(const PendingEntity entity) { this->push(&applyRemove<T>, Target{{}, entity.index}); }
+
+            // Runs the commands of every buffer by key, each key in record order, then clears the buffers.
+            // Equal keys of different buffers run in buffer order. Must not run while the handler is iterated
+            template<typename Buffers>
+            static void applyAll(Handler& handler, const Buffers& buffers, std::vector<Entry>& entries)
+            {
+                entries.clear();
+
+                for (const auto& buffer : buffers) {
+                    buffer->created.resize(buffer->pendingCount);
+
+                    for (Command* command = buffer->head; command; command = command->next)
+                        entries.push_back({command->key, &*buffer, command});
+                }
+
+                std::ranges::stable_sort(entries, {}, &Entry::key);
+
+                for (const Entry& entry : entries)
+                    entry.command->apply(handler, entry.command->payload, entry.buffer->created);
+
+                for (const auto& buffer : buffers)
+                    buffer->clear();
+            }
+
+            // Drops the commands, keeping the blocks for the next ones
+            void clear()
+            {
+                for (Command* command = this->head; command; command = command->next)
+                    if (command->destroy)
+                        command->destroy(command->payload);
+
+                for (Block& block : this->blocks)
+                    block.used = 0;
+
+                this->currentBlock = 0;
+                this->head = nullptr;
+                this->tail = nullptr;
+                this->count = 0;
+                this->pendingCount = 0;
+                this->created.clear();
+            }
+
+            [[nodiscard]] bool empty() const { return this->count == 0; }
+            [[nodiscard]] std::size_t size() const { return this->count; }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include "Components/Movements.h"
 #include "Components/PlayerInput.h"
 #include "Components/Inventory.h"
+#include "Components/TickLod.h"
 
 namespace ECS::InventoryUtils
 {
@@ -50,19 +51,20 @@ namespace ECS::Creator
         return player;
     }
 
-    inline IEntity createZombie(Handler& handler, const World& world)
+    inline IEntity createZombie(Handler& handler, const World& world, const Position& position = Position{7.5f, 73.f, 7.5f})
     {
         const auto mesh = world.getRegistries().get<MeshRegistry>().get("zombie");
         const auto texture = world.getRegistries().get<TextureRegistry>().getByName("zombie");
         const auto zombie = handler.createEntity();
 
-        handler.addComponent(zombie, Position{7.5f, 73.f, 7.5f});
+        handler.addComponent(zombie, position);
         handler.addComponent(zombie, Rotation{});
         handler.addComponent(zombie, Velocity{});
         handler.addComponent(zombie, Gravity{});
         handler.addComponent(zombie, CollisionBox{{0.45f, 1.f, 0.3f}});
         handler.addComponent(zombie, Equipments{});
         handler.addComponent(zombie, MeshRef{ mesh, texture });
+        handler.addComponent(zombie, TickLod{});
 
         InventoryUtils::equipHand(handler, zombie, world.getRegistries().get<ItemRegistry>().createStack("core:iron_sword", 1));
 
@@ -7,8 +7,13 @@
 #include <memory>
 #include <limits>
 #include <ranges>
+#include <tuple>
+#include <utility>
 
 #include "ECS/IEntity.h"
+#include "ECS/Query.h"
+#include "ECS/CommandBuffer.h"
+#include "JobSystem.h"
 
 namespace ECS
 {
@@ -23,30 +28,40 @@ namespace ECS
     };
 
     template<typename T>
-    class ComponentPool : public IComponentPool
+    class ComponentPool final : public IComponentPool
     {
         SparseSet entitySet;
         std::vector<T> components;
+        std::vector<ChangeTicks> ticks; // Parallel to components
+        const ChangeTick* clock;
+
+        [[nodiscard]] ChangeTick now() const { return this->clock ? *this->clock : 0; }
 
         public:
-            explicit ComponentPool(std::size_t max_entities = 0) :
-                entitySet(max_entities)
+            explicit ComponentPool(std::size_t max_entities = 0, const ChangeTick* _clock = nullptr) :
+                entitySet(max_entities),
+                clock(_clock)
             {}
 
+            // Overwriting an owned component counts as a change
             T& add(const EntityId id, const T& component)
             {
                 if (entitySet.contains(id)) {
                     const Index index = entitySet.getIndex(id);
                     components[index] = component;
+                    ticks[index].changed = this->now();
                     return components[index];
                 }
 
                 const Index index = entitySet.insert(id);
 
-                if (index >= components.size())
+                if (index >= components.size()) {
                     components.resize(index + 1);
+                    ticks.resize(index + 1);
+                }
 
                 components[index] = component;
+                ticks[index] = {this->now(), this->now()};
                 return components[index];
             }
 
@@ -68,6 +83,29 @@ namespace ECS
                 const Index index = entitySet.getIndex(id);
                 return &components[index];
             }
+            [[nodiscard]] const T* tryGet(const EntityId id) const
+            {
+                if (!entitySet.contains(id))
+                    return nullptr;
+
+                const Index index = entitySet.getIndex(id);
+                return &components[index];
+            }
+
+            [[nodiscard]] const ChangeTicks* tryGetTicks(const EntityId id) const
+            {
+                if (!entitySet.contains(id))
+                    return nullptr;
+
+                return &ticks[entitySet.getIndex(id)];
+            }
+
+            // Writes through get/tryGet aren't tracked, writers report them here for changed<T> queries
+            void markChanged(const EntityId id)
+            {
+                if (entitySet.contains(id))
+                    ticks[entitySet.getIndex(id)].changed = this->now();
+            }
 
             void remove(const EntityId id) override
             {
@@ -77,8 +115,10 @@ namespace ECS
                 Index removed_index = entitySet.getIndex(id);
                 auto last_index = static_cast<Index>(entitySet.size() - 1);
 
-                if (removed_index != last_index)
+                if (removed_index != last_index) {
                     components[removed_index] = std::move(components[last_index]);
+                    ticks[removed_index] = ticks[last_index];
+                }
 
                 entitySet.remove(id);
             }
@@ -101,6 +141,7 @@ namespace ECS
             {
                 entitySet = SparseSet{};
                 components.clear();
+                ticks.clear();
             }
             [[nodiscard]] std::size_t size() const override { return entitySet.size(); }
 
@@ -120,154 +161,96 @@ namespace ECS
             }
     };
 
-    template<typename T>
+    // Iterates the smallest required pool and looks every other argument up by id
+    template<typename... Ts>
     class View
     {
-        ComponentPool<T>& pool;
+        static_assert((QueryArg<Ts>::REQUIRED || ...), "A query needs at least one required component");
+
+        // Entities per parallelForEach job
+        static constexpr std::size_t PARALLEL_BATCH = 64;
+
+        std::tuple<ComponentPool<typename QueryArg<Ts>::Component>*...> pools;
+        ChangeTick since;
 
         public:
-            explicit View(ComponentPool<T>& pool) :
-                pool(pool)
+            explicit View(const ChangeTick _since, ComponentPool<typename QueryArg<Ts>::Component>&... _pools) :
+                pools(&_pools...),
+                since(_since)
             {}
 
             template<typename Func>
             void forEach(Func&& callback)
             {
-                const auto& dense = pool.getEntitySet().getDense();
+                const SparseSet& lead = this->getLead(std::index_sequence_for<Ts...>{});
+                const auto& dense = lead.getDense();
 
-                for (std::size_t i = 0; i < pool.size(); ++i)
-                    callback(dense[i], pool.get(dense[i]));
+                for (std::size_t i = 0; i < lead.size(); ++i)
+                    this->visit(dense[i], callback, std::index_sequence_for<Ts...>{});
             }
-    };
-
-    template<typename T1, typename T2>
-    class View2
-    {
-        ComponentPool<T1>& pool1;
-        ComponentPool<T2>& pool2;
-
-        public:
-            View2(ComponentPool<T1>& pool1, ComponentPool<T2>& pool2) :
-                pool1(pool1),
-                pool2(pool2)
-            {}
 
+            // Same as forEach with batches of entities spread over the job system, the callback must be thread safe
             template<typename Func>
-            void forEach(Func&& callback)
+            void parallelForEach(JobSystem& jobSystem, Func&& callback)
             {
-                if (pool1.size() <= pool2.size())
-                {
-                    const auto& dense = pool1.getEntitySet().getDense();
-                    for (std::size_t i = 0; i < pool1.size(); ++i)
-                    {
-                        const EntityId id = dense[i];
-                        if (pool2.has(id))
-                            callback(id, pool1.get(id), pool2.get(id));
-                    }
-                }
-                else
-                {
-                    const auto& dense = pool2.getEntitySet().getDense();
-                    for (std::size_t i = 0; i < pool2.size(); ++i)
-                    {
-                        const EntityId id = dense[i];
-                        if (pool1.has(id))
-                            callback(id, pool1.get(id), pool2.get(id));
-                    }
-                }
+                const SparseSet& lead = this->getLead(std::index_sequence_for<Ts...>{});
+                const auto& dense = lead.getDense();
+                const std::size_t size = lead.size();
+                const ParallelCommandPass pass;
+
+                jobSystem.parallelFor((size + PARALLEL_BATCH - 1) / PARALLEL_BATCH, [&](const std::size_t batch) {
+                    const CommandScope scope(pass.batch(batch));
+                    const std::size_t end = std::min(size, (batch + 1) * PARALLEL_BATCH);
+
+                    for (std::size_t i = batch * PARALLEL_BATCH; i < end; ++i)
+                        this->visit(dense[i], callback, std::index_sequence_for<Ts...>{});
+                });
             }
-    };
 
-    template<typename T1, typename T2, typename T3>
-    class View3
-    {
-        ComponentPool<T1>& pool1;
-        ComponentPool<T2>& pool2;
-        ComponentPool<T3>& pool3;
+            // Chunked form for batch kernels, see ECS/Query.h. Pools don't share a row order, so every entity is its own chunk
+            template<typename Func>
+            void forEachChunk(Func&& callback)
+            {
+                static_assert(!HAS_TICK_FILTER<Ts...>, "forEachChunk can't filter on changed<> or added<>");
 
-        public:
-            View3(ComponentPool<T1>& p1, ComponentPool<T2>& p2, ComponentPool<T3>& p3) :
-                pool1(p1),
-                pool2(p2),
-                pool3(p3)
-            {}
+                const SparseSet& lead = this->getLead(std::index_sequence_for<Ts...>{});
+                const auto& dense = lead.getDense();
 
-            template<typename Func>
-            void forEach(Func&& callback)
+                for (std::size_t i = 0; i < lead.size(); ++i)
+                    this->visitChunk(dense[i], callback, std::index_sequence_for<Ts...>{});
+            }
+
+        private:
+            template<std::size_t... I>
+            const SparseSet& getLead(std::index_sequence<I...>) const
             {
-                // Find the smallest pool
-                std::size_t smallestSize = pool1.size();
-
-                if (pool2.size() < smallestSize) smallestSize = pool2.size();
-                if (pool3.size() < smallestSize) smallestSize = pool3.size();
-
-                // Iterate the smallest pool, check others
-                auto iterate = [&](auto& leadPool)
-                {
-                    const auto& dense = leadPool.getEntitySet().getDense();
-                    for (std::size_t i = 0; i < leadPool.size(); ++i)
-                    {
-                        const EntityId id = dense[i];
-                        if (pool1.has(id) && pool2.has(id) && pool3.has(id))
-                            callback(id, pool1.get(id), pool2.get(id), pool3.get(id));
-                    }
+                const SparseSet* lead = nullptr;
+
+                const auto pickLead = [&](const auto* pool) {
+                    if (!lead || pool->size() < lead->size())
+                        lead = &pool->getEntitySet();
                 };
+                ((QueryArg<Ts>::REQUIRED ? pickLead(std::get<I>(this->pools)) : void()), ...);
 
-                if (pool1.size() == smallestSize)
-                    iterate(pool1);
-                else if (pool2.size() == smallestSize)
-                    iterate(pool2);
-                else
-                    iterate(pool3);
+                return *lead;
             }
-    };
 
-    template<typename T1, typename T2, typename T3, typename T4>
-    class View4
-    {
-        ComponentPool<T1>& pool1;
-        ComponentPool<T2>& pool2;
-        ComponentPool<T3>& pool3;
-        ComponentPool<T4>& pool4;
+            template<typename Func, std::size_t... I>
+            void visit(const EntityId id, Func& callback, std::index_sequence<I...>)
+            {
+                const std::tuple<typename QueryArg<Ts>::Pointer...> found{QueryArg<Ts>::lookup(*std::get<I>(this->pools), id)...};
 
-        public:
-            View4(ComponentPool<T1>& p1, ComponentPool<T2>& p2, ComponentPool<T3>& p3, ComponentPool<T4>& p4) :
-                pool1(p1),
-                pool2(p2),
-                pool3(p3),
-                pool4(p4)
-            {}
+                if ((acceptsQueryArg<Ts>(std::get<I>(found), this->since) && ...))
+                    std::apply(callback, std::tuple_cat(std::tuple<EntityId>{id}, QueryArg<Ts>::forward(std::get<I>(found))...));
+            }
 
-            template<typename Func>
-            void forEach(Func&& callback)
+            template<typename Func, std::size_t... I>
+            void visitChunk(const EntityId& id, Func& callback, std::index_sequence<I...>)
             {
-                // Find the smallest pool
-                std::size_t smallestSize = pool1.size();
-
-                if (pool2.size() < smallestSize) smallestSize = pool2.size();
-                if (pool3.size() < smallestSize) smallestSize = pool3.size();
-                if (pool4.size() < smallestSize) smallestSize = pool4.size();
-
-                // Iterate the smallest pool, check others
-                auto iterate = [&](auto& leadPool)
-                {
-                    const auto& dense = leadPool.getEntitySet().getDense();
-                    for (std::size_t i = 0; i < leadPool.size(); ++i)
-                    {
-                        const EntityId id = dense[i];
-                        if (pool1.has(id) && pool2.has(id) && pool3.has(id) && pool4.has(id))
-                            callback(id, pool1.get(id), pool2.get(id), pool3.get(id), pool4.get(id));
-                    }
-                };
+                const std::tuple<typename QueryArg<Ts>::Pointer...> found{QueryArg<Ts>::lookup(*std::get<I>(this->pools), id)...};
 
-                if (pool1.size() == smallestSize)
-                    iterate(pool1);
-                else if (pool2.size() == smallestSize)
-                    iterate(pool2);
-                else if (pool3.size() == smallestSize)
-                    iterate(pool3);
-                else
-                    iterate(pool4);
+                if ((acceptsQueryArg<Ts>(std::get<I>(found), this->since) && ...))
+                    std::apply(callback, std::tuple_cat(std::tuple<std::size_t, const EntityId*>{1, &id}, QueryArg<Ts>::forwardColumn(std::get<I>(found))...));
             }
     };
 }
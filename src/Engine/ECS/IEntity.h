@@ -144,6 +144,12 @@ namespace ECS
                     return false;
                 return generations[entity.id] == entity.generation;
             }
+
+            // Current handle of an id, queries only give ids
+            [[nodiscard]] IEntity get(const EntityId id) const
+            {
+                return IEntity::makeEntity(id, generations[id]);
+            }
     };
 }
 
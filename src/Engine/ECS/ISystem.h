@@ -2,7 +2,6 @@
 #define FARFIELD_ECSSYSTEM_H
 
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 #include <algorithm>
 #include <memory>
@@ -12,40 +11,73 @@
 
 #include "ECS/IEntity.h"
 #include "ECS/IComponent.h"
+#include "ECS/Archetype.h"
+#include "ECS/CommandBuffer.h"
+#include "JobSystem.h"
 
 namespace ECS
 {
+    // Sparse set storage by default, archetype tables when built with FARFIELD_ECS_ARCHETYPE.
+    // Creating, destroying, adding or removing while a query is walked moves the storage under it,
+    // systems record those changes in getCommands() instead, applied by applyCommands().
+    // Components are stamped with the change tick when added or marked changed, for changed<> and added<> queries
     class Handler
     {
         EntityManager entityManager;
-        std::unordered_map<std::uint32_t, std::unique_ptr<IComponentPool>> componentPools;
+        std::vector<std::unique_ptr<IComponentPool>> componentPools; // Indexed by component type id
+        std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;  // Indexed by JobSystem::getThreadSlot()
+        std::vector<CommandBuffer::Entry> commandEntries;            // Merge order of applyCommands, kept across flushes
         std::uint32_t maxEntities;
+        ChangeTick changeTick = 1; // Above the 0 a system that never ran queries since
 
+#ifdef FARFIELD_ECS_ARCHETYPE
+        ArchetypeStorage storage{maxEntities, &changeTick};
+
+        public:
+            template<typename T>
+            using Pool = ArchetypePool<T>;
+#else
         public:
+            template<typename T>
+            using Pool = ComponentPool<T>;
+#endif
+
             explicit Handler(const std::uint32_t max = 10000) :
                 maxEntities(max)
-            {}
+            {
+                commandBuffers.push_back(std::make_unique<CommandBuffer>());
+            }
 
             template<typename T>
-            ComponentPool<T>& getPool()
+            Pool<T>& getPool()
             {
-                std::uint32_t typeId = ComponentTypeRegistry::getTypeId<T>();
+                using Component = std::remove_const_t<T>;
+                const std::uint32_t typeId = ComponentTypeRegistry::getTypeId<Component>();
+
+                if (typeId >= componentPools.size())
+                    componentPools.resize(typeId + 1);
 
-                const auto it = componentPools.find(typeId);
-                if (it == componentPools.end())
+                auto& slot = componentPools[typeId];
+                if (!slot)
                 {
-                    auto pool = std::make_unique<ComponentPool<T>>(maxEntities);
-                    auto* ptr = pool.get();
-                    componentPools[typeId] = std::move(pool);
-                    return *static_cast<ComponentPool<T>*>(ptr);
+#ifdef FARFIELD_ECS_ARCHETYPE
+                    slot = std::make_unique<ArchetypePool<Component>>(storage);
+#else
+                    slot = std::make_unique<ComponentPool<Component>>(maxEntities, &changeTick);
+#endif
                 }
 
-                return *static_cast<ComponentPool<T>*>(it->second.get());
+                return *static_cast<Pool<Component>*>(slot.get());
             }
 
             IEntity createEntity()
             {
-                return entityManager.create();
+                const IEntity entity = entityManager.create();
+
+#ifdef FARFIELD_ECS_ARCHETYPE
+                storage.create(entity.id);
+#endif
+                return entity;
             }
 
             void destroyEntity(const IEntity entity)
@@ -53,12 +85,27 @@ namespace ECS
                 if (!entityManager.isAlive(entity))
                     return;
 
-                for (const auto& pool : componentPools | std::views::values)
-                    pool->remove(entity.id);
+#ifdef FARFIELD_ECS_ARCHETYPE
+                storage.destroy(entity.id);
+#else
+                for (const auto& pool : componentPools)
+                    if (pool)
+                        pool->remove(entity.id);
+#endif
 
                 entityManager.destroy(entity);
             }
 
+            [[nodiscard]] bool isAlive(const IEntity entity) const
+            {
+                return entityManager.isAlive(entity);
+            }
+
+            [[nodiscard]] IEntity getEntity(const EntityId id) const
+            {
+                return entityManager.get(id);
+            }
+
             template<typename T>
             T& addComponent(IEntity entity, const T& component)
             {
@@ -84,68 +131,203 @@ namespace ECS
             template<typename T>
             bool hasComponent(const IEntity entity) const
             {
-                const std::uint32_t type_id = ComponentTypeRegistry::getTypeId<T>();
+#ifdef FARFIELD_ECS_ARCHETYPE
+                return storage.has<T>(entity.id);
+#else
+                const std::uint32_t typeId = ComponentTypeRegistry::getTypeId<T>();
 
-                const auto it = componentPools.find(type_id);
-                if (it == componentPools.end())
+                if (typeId >= componentPools.size() || !componentPools[typeId])
                     return false;
 
-                return it->second->has(entity.id);
+                return componentPools[typeId]->has(entity.id);
+#endif
             }
 
+            // See ECS/Query.h for the accepted arguments, since only matters to changed<> and added<>
+            template<typename... Ts>
+            auto query(const ChangeTick since = 0)
+            {
+#ifdef FARFIELD_ECS_ARCHETYPE
+                return ArchetypeView<Ts...>(storage, since);
+#else
+                return View<Ts...>(since, getPool<typename QueryArg<Ts>::Component>()...);
+#endif
+            }
+
+            // Reports a write through a reference, the entity passes changed<T> queries since an earlier tick.
+            // Same thread rules as writing the component
             template<typename T>
-            View<T> query()
+            void markChanged(const EntityId id)
             {
-                return View<T>(getPool<T>());
+                getPool<T>().markChanged(id);
             }
 
-            template<typename T1, typename T2>
-            View2<T1, T2> query()
+            [[nodiscard]] ChangeTick getChangeTick() const { return changeTick; }
+
+            ChangeTick advanceChangeTick() { return ++changeTick; }
+
+            // Command buffer of the calling thread
+            CommandBuffer& getCommands()
             {
-                return View2<T1, T2>(getPool<T1>(), getPool<T2>());
+                const std::size_t slot = JobSystem::getThreadSlot();
+
+                if (slot >= commandBuffers.size())
+                    throw std::runtime_error("[ECS::Handler::getCommands] No command buffer for this thread");
+                return *commandBuffers[slot];
             }
 
-            template<typename T1, typename T2, typename T3>
-            View3<T1, T2, T3> query()
+            // One buffer per JobSystem thread slot, not while systems run
+            void reserveCommandBuffers(const std::size_t count)
             {
-                return View3<T1, T2, T3>(getPool<T1>(), getPool<T2>(), getPool<T3>());
+                while (commandBuffers.size() < count)
+                    commandBuffers.push_back(std::make_unique<CommandBuffer>());
             }
 
-            template<typename T1, typename T2, typename T3, typename T4>
-            View4<T1, T2, T3, T4> query()
+            // Applies the commands of every buffer by CommandKey, so entity ids don't depend on which thread ran which batch
+            void applyCommands()
             {
-                return View4<T1, T2, T3, T4>(getPool<T1>(), getPool<T2>(), getPool<T3>(), getPool<T4>());
+                CommandBuffer::applyAll(*this, commandBuffers, commandEntries);
             }
     };
 
+    // Components a system touches, resolved to type ids when the scheduler builds its stages
+    struct SystemAccess
+    {
+        std::vector<std::uint32_t> reads;
+        std::vector<std::uint32_t> writes;
+        bool exclusive = false; // Undeclared systems conflict with every other one
+
+        static SystemAccess exclusiveAccess()
+        {
+            return SystemAccess{.reads = {}, .writes = {}, .exclusive = true};
+        }
+
+        [[nodiscard]] bool conflictsWith(const SystemAccess& other) const
+        {
+            if (this->exclusive || other.exclusive)
+                return true;
+
+            const auto overlaps = [](const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b) {
+                return std::ranges::any_of(a, [&](const std::uint32_t id) { return std::ranges::find(b, id) != b.end(); });
+            };
+            return overlaps(this->writes, other.writes) || overlaps(this->writes, other.reads) || overlaps(other.writes, this->reads);
+        }
+    };
+
+    // Declared by a system as `using Access = ComponentAccess<...>`, with the query arguments of ECS/Query.h:
+    // T and optional<T> write, const T, optional<const T>, without<T>, changed<T> and added<T> read.
+    // Every component the system queries must be listed, pools are created up front so systems never add one concurrently
+    template<typename... Ts>
+    struct ComponentAccess
+    {
+        static SystemAccess resolve(Handler& handler)
+        {
+            SystemAccess access;
+
+            const auto add = [&]<typename T>() {
+                using Component = typename QueryArg<T>::Component;
+
+                handler.getPool<Component>();
+                (QueryArg<T>::WRITES ? access.writes : access.reads).push_back(ComponentTypeRegistry::getTypeId<Component>());
+            };
+            (add.template operator()<Ts>(), ...);
+
+            return access;
+        }
+    };
+
     class ISystem
     {
+        friend class SystemScheduler;
+
+        ChangeTick lastRunTick = 0;
+
         public:
             virtual ~ISystem() = default;
             virtual void update(Handler& handler, float deltaTime) = 0;
+
+            // Tick of the previous update, what changed<> and added<> queries pass as since to see what happened after it
+            [[nodiscard]] ChangeTick getLastRunTick() const { return lastRunTick; }
     };
 
     class IRenderSystem
     {
+        friend class SystemScheduler;
+
+        ChangeTick lastRunTick = 0;
+
         public:
             virtual ~IRenderSystem() = default;
             virtual void render(Handler& handler) = 0;
+
+            [[nodiscard]] ChangeTick getLastRunTick() const { return lastRunTick; }
     };
 
+    // Runs update systems in stages: a system goes one stage after the last earlier registered system it conflicts with,
+    // so conflicting systems keep their registration order and the systems of a stage run concurrently on the job system.
+    // Recorded commands are applied after every stage, the next stage sees their changes.
+    // Every stage and every command flush gets its own change tick, a system sees the changes of the other stages
+    // since its previous update but not its own
     class SystemScheduler
     {
+        using AccessResolver = SystemAccess(*)(Handler&);
+
+        JobSystem& jobSystem;
         std::vector<std::unique_ptr<ISystem>> systems;
+        std::vector<AccessResolver> accessResolvers; // Null for systems without an Access declaration
         std::vector<std::unique_ptr<IRenderSystem>> renderSystems;
+        std::vector<std::vector<std::size_t>> stages;
+        bool stagesDirty = true;
+
+        void buildStages(Handler& handler)
+        {
+            std::vector<SystemAccess> accesses;
+            std::vector<std::size_t> stageOf(this->systems.size(), 0);
+
+            for (const AccessResolver resolver : this->accessResolvers)
+                accesses.push_back(resolver ? resolver(handler) : SystemAccess::exclusiveAccess());
+
+            this->stages.clear();
+            for (std::size_t i = 0; i < this->systems.size(); i++) {
+                for (std::size_t j = 0; j < i; j++)
+                    if (accesses[i].conflictsWith(accesses[j]))
+                        stageOf[i] = std::max(stageOf[i], stageOf[j] + 1);
+
+                if (stageOf[i] >= this->stages.size())
+                    this->stages.resize(stageOf[i] + 1);
+                this->stages[stageOf[i]].push_back(i);
+            }
+
+            this->stagesDirty = false;
+        }
+
+        // Commands the system records are keyed by its index, see CommandKey
+        void runSystem(Handler& handler, const std::size_t index, const float dt)
+        {
+            const CommandScope scope({static_cast<std::uint32_t>(index), 0, 0});
+            this->systems[index]->update(handler, dt);
+        }
 
         public:
+            explicit SystemScheduler(JobSystem& _jobSystem) :
+                jobSystem(_jobSystem)
+            {}
+
             template<typename T, typename... Args>
             T& registerSystem(Args&&... args)
             {
                 auto system = std::make_unique<T>(std::forward<Args>(args)...);
                 auto* ptr = system.get();
 
-                if constexpr (std::is_base_of_v<ISystem, T>)
+                if constexpr (std::is_base_of_v<ISystem, T>) {
                     systems.push_back(std::move(system));
+
+                    if constexpr (requires { typename T::Access; })
+                        accessResolvers.push_back(&T::Access::resolve);
+                    else
+                        accessResolvers.push_back(nullptr);
+                    stagesDirty = true;
+                }
                 else if constexpr (std::is_base_of_v<IRenderSystem, T>)
                     renderSystems.push_back(std::move(system));
 
@@ -166,16 +348,40 @@ namespace ECS
                 throw std::runtime_error("[Farfield::ECS::getSystem] System not registered");
             }
 
-            void update(Handler& handler, const float dt) const
+            void update(Handler& handler, const float dt)
             {
-                for (const auto& system : systems)
-                    system->update(handler, dt);
+                if (this->stagesDirty) {
+                    this->buildStages(handler);
+                    handler.reserveCommandBuffers(this->jobSystem.getThreadCount() + 1);
+                }
+
+                for (const auto& stage : this->stages) {
+                    const ChangeTick tick = handler.advanceChangeTick();
+
+                    if (stage.size() == 1)
+                        this->runSystem(handler, stage.front(), dt);
+                    else {
+                        this->jobSystem.parallelFor(stage.size(), [&](const std::size_t i) {
+                            this->runSystem(handler, stage[i], dt);
+                        });
+                    }
+
+                    for (const std::size_t system : stage)
+                        this->systems[system]->lastRunTick = tick;
+
+                    handler.advanceChangeTick();
+                    handler.applyCommands();
+                }
             }
 
             void render(Handler& handler) const
             {
-                for (const auto& system : renderSystems)
+                for (const auto& system : renderSystems) {
+                    const ChangeTick tick = handler.advanceChangeTick();
+
                     system->render(handler);
+                    system->lastRunTick = tick;
+                }
             }
     };
 }
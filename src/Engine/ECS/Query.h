@@ -0,0 +1,151 @@
+#ifndef FARFIELD_QUERY_H
+#define FARFIELD_QUERY_H
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+#include "ECS/IEntity.h"
+
+// Query arguments of Handler::query<Ts...>(since):
+//  - T          the entity must own T, the callback gets T&
+//  - const T    same, read only, the callback gets const T&
+//  - optional<T> the callback gets T*, null when the entity doesn't own T
+//  - without<T>  entities owning T are skipped, nothing is passed to the callback
+//  - changed<T>  the entity must own T, added or marked changed after the since tick, nothing is passed
+//  - added<T>    the entity must own T, added after the since tick, nothing is passed
+// The callback receives the entity id, then one argument per T, const T and optional<T>, in query order.
+// forEachChunk callbacks get (count, entity ids, then one pointer per T, const T and optional<T> to count components)
+// instead, they can't filter on ticks
+namespace ECS
+{
+    // Stamped on components when they're added or marked changed, the handler advances it once per scheduler stage
+    using ChangeTick = std::uint32_t;
+
+    struct ChangeTicks
+    {
+        ChangeTick added = 0;
+        ChangeTick changed = 0;
+    };
+
+    // tick > since, wrap safe
+    constexpr bool isNewerTick(const ChangeTick tick, const ChangeTick since)
+    {
+        return static_cast<std::int32_t>(tick - since) > 0;
+    }
+
+    template<typename T>
+    struct without {};
+
+    template<typename T>
+    struct optional {};
+
+    template<typename T>
+    struct changed {};
+
+    template<typename T>
+    struct added {};
+
+    template<typename T>
+    struct QueryArg
+    {
+        using Component = std::remove_const_t<T>;
+        using Pointer = T*;
+
+        static constexpr bool REQUIRED = true;
+        static constexpr bool EXCLUDED = false;
+        static constexpr bool WRITES = !std::is_const_v<T>;
+        static constexpr bool TICK_FILTER = false;
+
+        template<typename Pool>
+        static Pointer lookup(Pool& pool, const EntityId id) { return pool.tryGet(id); }
+
+        static std::tuple<T&> forward(const Pointer component) { return {*component}; }
+        static std::tuple<Pointer> forwardColumn(const Pointer column) { return {column}; }
+    };
+
+    template<typename T>
+    struct QueryArg<optional<T>>
+    {
+        using Component = std::remove_const_t<T>;
+        using Pointer = T*;
+
+        static constexpr bool REQUIRED = false;
+        static constexpr bool EXCLUDED = false;
+        static constexpr bool WRITES = !std::is_const_v<T>;
+        static constexpr bool TICK_FILTER = false;
+
+        template<typename Pool>
+        static Pointer lookup(Pool& pool, const EntityId id) { return pool.tryGet(id); }
+
+        static std::tuple<T*> forward(const Pointer component) { return {component}; }
+        static std::tuple<Pointer> forwardColumn(const Pointer column) { return {column}; }
+    };
+
+    template<typename T>
+    struct QueryArg<without<T>>
+    {
+        using Component = std::remove_const_t<T>;
+        using Pointer = const Component*;
+
+        static constexpr bool REQUIRED = false;
+        static constexpr bool EXCLUDED = true;
+        static constexpr bool WRITES = false;
+        static constexpr bool TICK_FILTER = false;
+
+        template<typename Pool>
+        static Pointer lookup(Pool& pool, const EntityId id) { return pool.tryGet(id); }
+
+        static std::tuple<> forward(Pointer) { return {}; }
+        static std::tuple<> forwardColumn(Pointer) { return {}; }
+    };
+
+    // changed<T> and added<T> look up the ticks of T instead of T itself
+    template<typename T, bool ADDED>
+    struct TickQueryArg
+    {
+        using Component = std::remove_const_t<T>;
+        using Pointer = const ChangeTicks*;
+
+        static constexpr bool REQUIRED = true;
+        static constexpr bool EXCLUDED = false;
+        static constexpr bool WRITES = false;
+        static constexpr bool TICK_FILTER = true;
+
+        template<typename Pool>
+        static Pointer lookup(Pool& pool, const EntityId id) { return pool.tryGetTicks(id); }
+
+        static bool isNew(const ChangeTicks& ticks, const ChangeTick since)
+        {
+            return isNewerTick(ADDED ? ticks.added : ticks.changed, since);
+        }
+
+        static std::tuple<> forward(Pointer) { return {}; }
+        static std::tuple<> forwardColumn(Pointer) { return {}; }
+    };
+
+    template<typename T>
+    struct QueryArg<changed<T>> : TickQueryArg<T, false> {};
+
+    template<typename T>
+    struct QueryArg<added<T>> : TickQueryArg<T, true> {};
+
+    template<typename... Ts>
+    inline constexpr bool HAS_TICK_FILTER = (QueryArg<Ts>::TICK_FILTER || ...);
+
+    // Whether a lookup result lets the entity through
+    template<typename T>
+    constexpr bool acceptsQueryArg(const typename QueryArg<T>::Pointer component, [[maybe_unused]] const ChangeTick since)
+    {
+        if constexpr (QueryArg<T>::TICK_FILTER)
+            return component != nullptr && QueryArg<T>::isNew(*component, since);
+        else if constexpr (QueryArg<T>::REQUIRED)
+            return component != nullptr;
+        else if constexpr (QueryArg<T>::EXCLUDED)
+            return component == nullptr;
+        else
+            return true;
+    }
+}
+
+#endif
\ No newline at end of file
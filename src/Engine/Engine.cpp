@@ -1,7 +1,34 @@
 #include "Engine.h"
 
-Engine::Engine() :
-    viewport(settings, &inputs),
+#include "Systems/TickLodSystem.h"
+#include "Systems/CollisionSystem.h"
+
+// Set by SIGINT/SIGTERM so headless runs shut down cleanly
+static std::atomic<bool> stopRequested{false};
+
+EngineOptions EngineOptions::fromArgs(const int argc, char** argv)
+{
+    EngineOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--headless")
+            options.headless = true;
+        else if (arg == "--ticks" && i + 1 < argc)
+            options.ticks = std::stoull(argv[++i]);
+        else if (arg == "--mobs" && i + 1 < argc)
+            options.mobs = std::stoull(argv[++i]);
+        else
+            throw std::runtime_error("[EngineOptions::fromArgs] Unknown option : " + arg);
+    }
+    return options;
+}
+
+Engine::Engine(const EngineOptions& _options) :
+    options(_options),
+    jobSystem(settings.getJobThreadCount()),
+    viewport(settings, &inputs, _options.headless),
     prefabRegistry(blockRegistry),
     itemRegistry(textureRegistry),
     itemMeshRegistry(this->textureRegistry, this->itemRegistry),
@@ -22,7 +49,9 @@ Engine::Engine() :
 
     // Instantiate members
     this->font = std::make_unique<MsdfFont>();
-    this->world = std::make_unique<World>(this->registries, this->inputs, this->settings);
+    this->world = std::make_unique<World>(this->registries, this->inputs, this->settings, this->jobSystem);
+    // Past the last tick ring by two chunks, so every ring and the frozen entities outside loaded chunks get some
+    this->world->spawnZombies(this->options.mobs, this->settings.getEntityTickDistances().back() + 2.f * Chunk::SIZE);
     this->playerController = std::make_unique<PlayerController>(*this->world, *this->font, this->viewport);
 }
 
@@ -65,6 +94,11 @@ void Engine::preciseWait(const double seconds) const
 
 void Engine::loop()
 {
+    if (this->options.headless) {
+        this->loopHeadless();
+        return;
+    }
+
     const auto targetFrameTime = this->settings.getFpsFrameTime();
     auto previousTime = Clock::now();
     double accumulator = 0.0;
@@ -111,6 +145,47 @@ void Engine::loop()
     this->viewport.closeWindow();
 }
 
+void Engine::loopHeadless()
+{
+    std::signal(SIGINT, [](int) { stopRequested.store(true, std::memory_order_relaxed); });
+    std::signal(SIGTERM, [](int) { stopRequested.store(true, std::memory_order_relaxed); });
+
+    const auto start = Clock::now();
+    auto previousTime = start;
+    uint64_t tick = 0;
+
+    while (!stopRequested.load(std::memory_order_relaxed) && (this->options.ticks == 0 || tick < this->options.ticks))
+    {
+        const auto frameStart = Clock::now();
+        const double frameTime = std::chrono::duration_cast<Duration>(frameStart - previousTime).count();
+
+        if (frameTime > 0.0)
+            this->viewport.updateFrameTimer(frameTime);
+        previousTime = frameStart;
+
+        // One simulation step per frame, as fast as the machine allows
+        this->update();
+        this->render();
+        tick++;
+    }
+
+    const double elapsed = std::chrono::duration_cast<Duration>(Clock::now() - start).count();
+    std::cout << "[Engine::loopHeadless] " << tick << " ticks in " << elapsed << "s ("
+              << (elapsed > 0.0 ? static_cast<double>(tick) / elapsed : 0.0) << " ticks/s)" << std::endl;
+
+    // Entity updates of the systems following the tick LOD, against what they'd run with every entity every tick
+    const auto& lod = this->world->getECSScheduler().getSystem<ECS::TickLodSystem>().getStats();
+    const auto perTick = [&](const uint64_t count) { return lod.ticks > 0 ? static_cast<double>(count) / static_cast<double>(lod.ticks) : 0.0; };
+
+    std::cout << "[Engine::loopHeadless] " << perTick(lod.updates) << " entity updates per tick with tick LOD, "
+              << perTick(lod.entityTicks) << " without (" << perTick(lod.frozen) << " frozen)" << std::endl;
+
+    const auto collision = this->world->getECSScheduler().getSystem<ECS::CollisionSystem>().getStats();
+
+    std::cout << "[Engine::loopHeadless] " << collision.resting << " of " << collision.resolutions
+              << " entity collision resolutions skipped as resting" << std::endl;
+}
+
 void Engine::update() const
 {
     this->world->update(this->viewport.getAspectRatio());
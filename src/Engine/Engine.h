@@ -17,7 +17,11 @@
 #include <thread>
 #include <memory>
 #include <chrono>
+#include <atomic>
+#include <csignal>
+#include <string>
 #include "Viewport.h"
+#include "JobSystem.h"
 #include "InputState.h"
 #include "BlockRegistry.h"
 #include "ItemRegistry.h"
@@ -32,13 +36,23 @@
 using Clock = std::chrono::steady_clock;
 using Duration = std::chrono::duration<double>;
 
+struct EngineOptions {
+    bool headless = false;  // No window nor GPU, rendering goes to the null backend
+    uint64_t ticks = 0;     // Simulation ticks to run before exiting, 0 runs until closed
+    std::size_t mobs = 0;   // Extra zombies spread around the player, so the headless tick LOD metric has entities to count
+
+    static EngineOptions fromArgs(int argc, char** argv);
+};
+
 class Engine {
     #ifdef _WIN32
         HANDLE frameTimer = nullptr;
     #endif
 
+    EngineOptions options;
     InputState inputs;
     Settings settings;
+    JobSystem jobSystem;
     Viewport viewport;
 
     BlockRegistry blockRegistry;
@@ -57,8 +71,11 @@ class Engine {
     void render() const;
     void preciseWait(double seconds) const;
 
+    // Fixed step loop without frame cap nor inputs, reports the tick rate on exit
+    void loopHeadless();
+
     public:
-        Engine();
+        explicit Engine(const EngineOptions& _options = {});
         ~Engine();
 
         void loop();
@@ -0,0 +1,222 @@
+#include "JobSystem.h"
+
+namespace
+{
+    // Set on worker threads so jobs submitted from a job land in the submitting worker's own queues
+    thread_local const JobSystem* currentSystem = nullptr;
+    thread_local std::size_t currentWorker = 0;
+}
+
+JobSystem::JobSystem(const std::size_t threadCount)
+{
+    const std::size_t count = std::max<std::size_t>(threadCount, 1);
+
+    this->workers.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        auto worker = std::make_unique<Worker>();
+
+        for (auto& queue : worker->queues)
+            queue.jobs.reserve(INITIAL_CAPACITY);
+        this->workers.push_back(std::move(worker));
+    }
+
+    // Start threads once every queue exists, as workers steal from each other
+    for (std::size_t i = 0; i < count; ++i)
+        this->workers[i]->thread = std::thread(&JobSystem::loop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    this->running.store(false, std::memory_order_release);
+    this->wakeEpoch.fetch_add(1, std::memory_order_release);
+    this->wakeEpoch.notify_all();
+
+    for (const auto& worker : this->workers)
+        worker->thread.join();
+}
+
+void JobSystem::submit(const JobPriority priority, const Job& job)
+{
+    auto& [jobs, mutex] = this->workers[this->pickWorker()]->queues[static_cast<std::size_t>(priority)];
+    std::vector<Job> storage; // Declared before the lock, the replaced storage is freed once it's released
+    {
+        std::unique_lock lock(mutex);
+
+        // A full heap gets its larger storage allocated unlocked, so thieves and reprioritize only wait for the copy
+        while (jobs.size() == jobs.capacity()) {
+            const std::size_t capacity = std::max<std::size_t>(jobs.capacity() * 2, INITIAL_CAPACITY);
+
+            lock.unlock();
+            storage.clear();
+            storage.reserve(capacity);
+            lock.lock();
+
+            if (jobs.size() < storage.capacity()) {
+                storage.assign(jobs.begin(), jobs.end());
+                jobs.swap(storage);
+            }
+        }
+
+        jobs.push_back(job);
+        std::push_heap(jobs.begin(), jobs.end());
+    }
+
+    this->pendingJobs.fetch_add(1, std::memory_order_relaxed);
+    this->wakeEpoch.fetch_add(1, std::memory_order_release);
+    this->wakeEpoch.notify_one();
+}
+
+void JobSystem::cancel(const void* context)
+{
+    // A running job may still submit follow-up jobs, so repeat until a full pass finds nothing
+    bool found = true;
+
+    while (found) {
+        found = false;
+
+        for (const auto& worker : this->workers) {
+            for (auto& [jobs, mutex] : worker->queues) {
+                std::lock_guard lock(mutex);
+
+                const auto dropped = std::erase_if(jobs, [&](const Job& job) { return job.context == context; });
+                if (dropped == 0)
+                    continue;
+
+                std::make_heap(jobs.begin(), jobs.end());
+                this->pendingJobs.fetch_sub(dropped, std::memory_order_relaxed);
+                found = true;
+            }
+        }
+
+        for (const auto& worker : this->workers) {
+            while (worker->activeContext.load(std::memory_order_acquire) == context) {
+                found = true;
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+void JobSystem::runParallel(const ParallelBatch::Body body, void* fn, const std::size_t count)
+{
+    if (count == 0)
+        return;
+
+    const std::size_t helpers = std::min(count - 1, this->workers.size());
+    ParallelBatch batch{body, fn, count};
+    batch.references.store(helpers, std::memory_order_relaxed);
+
+    for (std::size_t i = 0; i < helpers; ++i)
+        this->submit(JobPriority::FRAME, Job{&JobSystem::runParallelJob, &batch});
+
+    batch.drain();
+
+    // Helpers still queued would find nothing left, take them back instead of waiting on busy workers.
+    // The ones already popped finish their indices and drop their reference
+    const std::size_t withdrawn = this->withdraw(JobPriority::FRAME, &batch);
+    batch.references.fetch_sub(withdrawn, std::memory_order_relaxed);
+
+    while (batch.references.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+}
+
+void JobSystem::runParallelJob(void* context, [[maybe_unused]] const Job& job)
+{
+    auto* batch = static_cast<ParallelBatch*>(context);
+
+    batch->drain();
+    batch->references.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::ParallelBatch::drain()
+{
+    for (std::size_t i = this->next.fetch_add(1, std::memory_order_relaxed); i < this->count; i = this->next.fetch_add(1, std::memory_order_relaxed))
+        this->body(this->fn, i);
+}
+
+std::size_t JobSystem::withdraw(const JobPriority priority, const void* context)
+{
+    std::size_t withdrawn = 0;
+
+    for (const auto& worker : this->workers) {
+        auto& [jobs, mutex] = worker->queues[static_cast<std::size_t>(priority)];
+        std::lock_guard lock(mutex);
+
+        const auto dropped = std::erase_if(jobs, [&](const Job& job) { return job.context == context; });
+        if (dropped == 0)
+            continue;
+
+        std::make_heap(jobs.begin(), jobs.end());
+        this->pendingJobs.fetch_sub(dropped, std::memory_order_relaxed);
+        withdrawn += dropped;
+    }
+    return withdrawn;
+}
+
+std::size_t JobSystem::getThreadSlot()
+{
+    return currentSystem ? currentWorker + 1 : 0;
+}
+
+std::size_t JobSystem::pickWorker()
+{
+    if (currentSystem == this)
+        return currentWorker;
+    return this->nextWorker.fetch_add(1, std::memory_order_relaxed) % this->workers.size();
+}
+
+bool JobSystem::tryPopFrom(JobQueue& queue, Worker& self, Job& out)
+{
+    std::lock_guard lock(queue.mutex);
+
+    if (queue.jobs.empty())
+        return false;
+
+    std::pop_heap(queue.jobs.begin(), queue.jobs.end());
+    out = queue.jobs.back();
+    queue.jobs.pop_back();
+
+    // Published under the queue lock so cancel() can't miss a job between pop and run
+    self.activeContext.store(out.context, std::memory_order_release);
+    return true;
+}
+
+bool JobSystem::tryPop(const std::size_t index, Job& out)
+{
+    Worker& self = *this->workers[index];
+    const std::size_t count = this->workers.size();
+
+    for (std::size_t priority = 0; priority < PRIORITY_COUNT; ++priority) {
+        // Own queue first, then steal the same class from the other workers
+        for (std::size_t offset = 0; offset < count; ++offset) {
+            Worker& victim = *this->workers[(index + offset) % count];
+
+            if (this->tryPopFrom(victim.queues[priority], self, out))
+                return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::loop(const std::size_t index)
+{
+    currentSystem = this;
+    currentWorker = index;
+
+    Worker& self = *this->workers[index];
+
+    while (this->running.load(std::memory_order_acquire)) {
+        const std::uint32_t epoch = this->wakeEpoch.load(std::memory_order_acquire);
+        Job job;
+
+        if (this->tryPop(index, job)) {
+            this->pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+            job.handler(job.context, job);
+            self.activeContext.store(nullptr, std::memory_order_release);
+            continue;
+        }
+
+        // Sleep until something is submitted after the epoch snapshot
+        this->wakeEpoch.wait(epoch, std::memory_order_acquire);
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef FARFIELD_JOBSYSTEM_H
+#define FARFIELD_JOBSYSTEM_H
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Priority classes, a worker always drains the higher classes (lower value) first
+enum class JobPriority : uint8_t
+{
+    FRAME,      // Work the current frame waits on, see JobSystem::parallelFor
+    MESH_EDIT,
+    MESH,
+    TERRAIN,
+    DECORATION,
+    BACKGROUND,
+
+    COUNT
+};
+
+struct Job
+{
+    static constexpr std::size_t PAYLOAD_SIZE = 32;
+
+    using Handler = void(*)(void* context, const Job& job);
+
+    Handler handler = nullptr;
+    void* context = nullptr;
+    float distance = 0.f; // ordering inside a priority class, lower runs first
+    alignas(8) std::array<std::byte, PAYLOAD_SIZE> payload{};
+
+    template<typename T>
+    static Job make(const Handler handler, void* context, const float distance, const T& data)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Job payload must be trivially copyable");
+        static_assert(sizeof(T) <= PAYLOAD_SIZE && alignof(T) <= 8, "Job payload is too large");
+
+        Job job{handler, context, distance};
+        std::memcpy(job.payload.data(), &data, sizeof(T));
+        return job;
+    }
+
+    template<typename T>
+    [[nodiscard]] T get() const
+    {
+        T data;
+        std::memcpy(&data, this->payload.data(), sizeof(T));
+        return data;
+    }
+
+    // Heap order, the closest job sits on top
+    bool operator<(const Job& other) const
+    {
+        return distance > other.distance;
+    }
+};
+
+class JobSystem {
+    public:
+        explicit JobSystem(std::size_t threadCount);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void submit(JobPriority priority, const Job& job);
+
+        // Re-key every queued job of a class in place, dropping the ones for which fn returns false
+        template<typename Fn>
+        void reprioritize(JobPriority priority, Fn&& fn);
+
+        // Drop every queued job of a context and wait for the running ones to finish
+        void cancel(const void* context);
+
+        // Run fn(i) for every i in [0, count) on the workers and the calling thread, return once all ran.
+        // The caller works through the indices too, so it never waits on workers busy with long jobs
+        template<typename Fn>
+        void parallelFor(std::size_t count, Fn&& fn);
+
+        [[nodiscard]] std::size_t getThreadCount() const { return this->workers.size(); }
+        [[nodiscard]] std::size_t getPendingCount() const { return this->pendingJobs.load(std::memory_order_relaxed); }
+
+        // Slot of the calling thread in [0, getThreadCount()]: 0 off the workers, worker index + 1 on them
+        [[nodiscard]] static std::size_t getThreadSlot();
+
+    private:
+        static constexpr std::size_t PRIORITY_COUNT = static_cast<std::size_t>(JobPriority::COUNT);
+        static constexpr std::size_t INITIAL_CAPACITY = 1024;
+
+        // Per worker, per class job heap. INITIAL_CAPACITY is reserved up front, past it the heap grows amortised:
+        // submit only allocates when it goes over the high-water mark, and does it outside the queue mutex
+        struct JobQueue {
+            std::vector<Job> jobs;
+            std::mutex mutex;
+        };
+
+        struct Worker {
+            std::array<JobQueue, PRIORITY_COUNT> queues;
+            std::atomic<const void*> activeContext{nullptr};
+            std::thread thread;
+        };
+
+        // Shared by the caller and the helper jobs of a parallelFor, lives on the caller's stack.
+        // references counts the helpers that may still touch it, the caller returns once it drops to 0
+        struct ParallelBatch {
+            using Body = void(*)(void* fn, std::size_t index);
+
+            Body body;
+            void* fn;
+            std::size_t count;
+            std::atomic<std::size_t> next{0};
+            std::atomic<std::size_t> references{0};
+
+            void drain();
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<bool> running{true};
+        std::atomic<std::size_t> nextWorker{0};
+        std::atomic<std::size_t> pendingJobs{0};
+        std::atomic<std::uint32_t> wakeEpoch{0};
+
+        void loop(std::size_t index);
+        bool tryPop(std::size_t index, Job& out);
+        bool tryPopFrom(JobQueue& queue, Worker& self, Job& out);
+        [[nodiscard]] std::size_t pickWorker();
+        std::size_t withdraw(JobPriority priority, const void* context);
+
+        void runParallel(ParallelBatch::Body body, void* fn, std::size_t count);
+        static void runParallelJob(void* context, const Job& job);
+};
+
+template<typename Fn>
+void JobSystem::parallelFor(const std::size_t count, Fn&& fn)
+{
+    const auto body = [](void* context, const std::size_t index) {
+        (*static_cast<std::remove_reference_t<Fn>*>(context))(index);
+    };
+
+    this->runParallel(body, const_cast<void*>(static_cast<const void*>(std::addressof(fn))), count);
+}
+
+template<typename Fn>
+void JobSystem::reprioritize(const JobPriority priority, Fn&& fn)
+{
+    for (const auto& worker : this->workers) {
+        auto& [jobs, mutex] = worker->queues[static_cast<std::size_t>(priority)];
+        std::lock_guard lock(mutex);
+
+        const auto dropped = std::erase_if(jobs, [&](Job& job) { return !fn(job); });
+        std::make_heap(jobs.begin(), jobs.end());
+
+        this->pendingJobs.fetch_sub(dropped, std::memory_order_relaxed);
+    }
+}
+
+#endif
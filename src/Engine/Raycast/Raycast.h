@@ -5,8 +5,6 @@
 
 #include "Material.h"
 #include "World.h"
-#include "Components/Movements.h"
-#include "Components/CollisionBox.h"
 
 namespace Raycast
 {
@@ -102,18 +100,14 @@ namespace Raycast
             t += STEP;
         }
 
-        // Iterate over entities to check along raycast
-        auto view = world.getECS().query<ECS::Position, ECS::CollisionBox>();
-        view.forEach([&](const ECS::EntityId id, const ECS::Position& pos, const ECS::CollisionBox& box)
+        // Test the entity boxes the grid finds along the ray, grid boxes follow the entity yaw
+        world.getEntityGrid().queryRay(origin, dir, dist, [&](const SpatialHash::Entry& candidate)
         {
-            if (id == world.getPlayerEntity().id)
+            if (candidate.id == world.getPlayerEntity().id)
                 return;
 
-            const glm::vec3 aabbMin = {pos.x - box.halfExtents.x, pos.y, pos.z - box.halfExtents.z};
-            const glm::vec3 aabbMax = {pos.x + box.halfExtents.x, pos.y + box.halfExtents.y * 2, pos.z + box.halfExtents.z};
-
             float tHit;
-            if (intersectAABB(origin, dir, aabbMin, aabbMax, closestEntityDist, tHit)) {
+            if (intersectAABB(origin, dir, candidate.min, candidate.max, closestEntityDist, tHit)) {
                 closestEntityDist = tHit;
                 entityHit = {
                     true,
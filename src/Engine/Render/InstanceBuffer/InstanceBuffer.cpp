@@ -0,0 +1,35 @@
+#include "InstanceBuffer.h"
+
+#include <algorithm>
+
+InstanceBuffer::InstanceBuffer(const GLuint _binding) :
+    binding(_binding)
+{
+    glGenBuffers(1, &this->ID);
+}
+
+InstanceBuffer::~InstanceBuffer()
+{
+    glDeleteBuffers(1, &this->ID);
+}
+
+void InstanceBuffer::upload(const std::vector<EntityInstance>& instances)
+{
+    const auto size = static_cast<GLsizeiptr>(instances.size() * sizeof(EntityInstance));
+
+    if (size == 0)
+        return;
+
+    if (size > this->capacity)
+        this->capacity = std::max(size, this->capacity * 2);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->ID);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, this->capacity, nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, instances.data());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void InstanceBuffer::bind() const
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, this->binding, this->ID);
+}
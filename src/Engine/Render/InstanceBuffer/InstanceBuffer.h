@@ -0,0 +1,28 @@
+#ifndef FARFIELD_INSTANCEBUFFER_H
+#define FARFIELD_INSTANCEBUFFER_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "VAOVertices.h"
+
+// Shader storage buffer of the per-instance data of instanced draws, kept alive across frames.
+// Storage only grows, every upload orphans the previous one so draws still reading it don't stall the upload
+class InstanceBuffer {
+    GLuint ID{};
+    GLuint binding;
+    GLsizeiptr capacity = 0; // Bytes
+
+    public:
+        explicit InstanceBuffer(GLuint _binding);
+        ~InstanceBuffer();
+
+        InstanceBuffer(const InstanceBuffer&) = delete;
+        InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+        void upload(const std::vector<EntityInstance>& instances);
+        void bind() const;
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "NullRenderBackend.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace
+{
+    std::atomic<GLuint> nextName{1};
+
+    template<typename R, typename... Args>
+    R APIENTRY ignore(Args...)
+    {
+        if constexpr (!std::is_void_v<R>)
+            return R{};
+    }
+
+    // Points a GL function to a stub of the same signature
+    template<typename R, typename... Args>
+    void stub(R (APIENTRYP& function)(Args...))
+    {
+        function = &ignore<R, Args...>;
+    }
+
+    void APIENTRY genNames(const GLsizei count, GLuint* names)
+    {
+        for (GLsizei i = 0; i < count; i++)
+            names[i] = nextName.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    GLuint APIENTRY createShader(GLenum)
+    {
+        return nextName.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    GLuint APIENTRY createProgram()
+    {
+        return nextName.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void APIENTRY getShaderiv(GLuint, const GLenum name, GLint* params)
+    {
+        *params = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+}
+
+void NullRenderBackend::load()
+{
+    // Objects
+    glad_glGenBuffers = genNames;
+    glad_glGenTextures = genNames;
+    glad_glGenVertexArrays = genNames;
+    stub(glad_glDeleteBuffers);
+    stub(glad_glDeleteTextures);
+    stub(glad_glDeleteVertexArrays);
+    stub(glad_glBindBuffer);
+    stub(glad_glBindBufferBase);
+    stub(glad_glBindTexture);
+    stub(glad_glBindVertexArray);
+    stub(glad_glActiveTexture);
+
+    // Uploads
+    stub(glad_glBufferData);
+    stub(glad_glBufferSubData);
+    stub(glad_glTexImage2D);
+    stub(glad_glTexStorage3D);
+    stub(glad_glTexSubImage3D);
+    stub(glad_glTexParameteri);
+    stub(glad_glVertexAttribPointer);
+    stub(glad_glVertexAttribIPointer);
+    stub(glad_glEnableVertexAttribArray);
+
+    // Shaders
+    glad_glCreateShader = createShader;
+    glad_glCreateProgram = createProgram;
+    glad_glGetShaderiv = getShaderiv;
+    stub(glad_glShaderSource);
+    stub(glad_glCompileShader);
+    stub(glad_glGetShaderInfoLog);
+    stub(glad_glAttachShader);
+    stub(glad_glLinkProgram);
+    stub(glad_glDeleteShader);
+    stub(glad_glDeleteProgram);
+    stub(glad_glUseProgram);
+    stub(glad_glGetUniformLocation);
+    stub(glad_glUniform1i);
+    stub(glad_glUniform1ui);
+    stub(glad_glUniform1f);
+    stub(glad_glUniform3f);
+    stub(glad_glUniform4f);
+    stub(glad_glUniformMatrix4fv);
+
+    // State and draws
+    stub(glad_glViewport);
+    stub(glad_glEnable);
+    stub(glad_glDisable);
+    stub(glad_glBlendFunc);
+    stub(glad_glDepthFunc);
+    stub(glad_glCullFace);
+    stub(glad_glPolygonOffset);
+    stub(glad_glClearColor);
+    stub(glad_glClear);
+    stub(glad_glDrawArrays);
+    stub(glad_glDrawArraysInstancedBaseInstance);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef FARFIELD_NULLRENDERBACKEND_H
+#define FARFIELD_NULLRENDERBACKEND_H
+
+#pragma once
+
+#include <glad/glad.h>
+
+// GL entry points for runs without a window or a GPU.
+// Every function the engine calls is pointed to a stub: object creation hands out fresh names,
+// compile queries succeed, and the rest does nothing, so meshes are built but never uploaded
+namespace NullRenderBackend
+{
+    void load();
+}
+
+#endif
\ No newline at end of file
@@ -110,3 +110,10 @@ void VAO::draw() const
     glDrawArrays(GL_TRIANGLES, 0, this->size);
     this->unbind();
 }
+
+void VAO::drawInstanced(const GLsizei instanceCount, const GLuint baseInstance) const
+{
+    this->bind();
+    glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, this->size, instanceCount, baseInstance);
+    this->unbind();
+}
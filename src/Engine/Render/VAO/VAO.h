@@ -27,6 +27,7 @@ class VAO {
         void bind() const;
         void unbind() const;
         void draw() const;
+        void drawInstanced(GLsizei instanceCount, GLuint baseInstance) const;
 };
 
 
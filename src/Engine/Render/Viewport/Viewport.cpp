@@ -1,8 +1,15 @@
 #include "Viewport.h"
 
-Viewport::Viewport(Settings &_settings, InputState* inputs) :
-    settings(_settings)
+Viewport::Viewport(Settings &_settings, InputState* inputs, const bool _headless) :
+    settings(_settings),
+    headless(_headless)
 {
+    if (this->headless) {
+        NullRenderBackend::load();
+        this->initViewport();
+        return;
+    }
+
     initGLFW();
     this->initWindow(inputs);
     this->initViewport();
@@ -90,12 +97,17 @@ void Viewport::initViewport() const
 
 void Viewport::closeWindow() const
 {
+    if (this->headless)
+        return;
+
     glfwDestroyWindow(this->window);
     glfwTerminate();
 }
 
 bool Viewport::shouldClose() const
 {
+    if (this->headless)
+        return false;
     return glfwWindowShouldClose(this->window);
 }
 
@@ -106,6 +118,8 @@ void Viewport::pollEvents()
 
 void Viewport::swapBuffers() const
 {
+    if (this->headless)
+        return;
     glfwSwapBuffers(this->window);
 }
 
@@ -135,7 +149,9 @@ glm::ivec2 Viewport::getSize() const
 void Viewport::useVSync(const bool use) const
 {
     this->settings.useVSync(use);
-    glfwSwapInterval(use ? 1 : 0);
+
+    if (!this->headless)
+        glfwSwapInterval(use ? 1 : 0);
 }
 
 bool Viewport::isUsingVSync() const
@@ -145,12 +161,17 @@ bool Viewport::isUsingVSync() const
 
 void Viewport::setCursorVisibility(const bool showCursor) const
 {
+    if (this->headless)
+        return;
     glfwSetInputMode(this->window, GLFW_CURSOR, showCursor ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
 }
 
 
 void Viewport::toggleFullscreen()
 {
+    if (this->headless)
+        return;
+
     const auto* videoMode = getVideoMode();
     const bool wouldBeFullscreen = !this->settings.isFullscreen();
 
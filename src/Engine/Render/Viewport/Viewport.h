@@ -11,6 +11,7 @@
 #include "FrameTimer.h"
 #include "Settings.h"
 #include "InputState.h"
+#include "NullRenderBackend.h"
 
 const std::unordered_map<int, int> SCREEN_SIZES = {
     {4320, 7680},
@@ -25,6 +26,7 @@ class Viewport
 {
     GLFWwindow *window{nullptr};
     Settings& settings;
+    bool headless{false}; // No window, GL goes to the null backend
     FrameTimer frameTimer;
 
     // Windows state
@@ -46,12 +48,13 @@ class Viewport
     public:
         static constexpr double dt = 1.f / 60.f; // 60Hz
 
-        explicit Viewport(Settings& _settings, InputState* inputs);
+        explicit Viewport(Settings& _settings, InputState* inputs, bool _headless = false);
 
         void closeWindow() const;
 
         [[nodiscard]] Settings& getSettings() const { return this->settings; }
         [[nodiscard]] GLFWwindow* getWindow() const { return this->window; }
+        [[nodiscard]] bool isHeadless() const { return this->headless; }
 
         static void pollEvents();
         void swapBuffers() const;
@@ -58,3 +58,48 @@ bool Settings::isFullscreen() const
 {
     return this->fullscreen;
 }
+
+void Settings::setJobThreadCount(const uint8_t count)
+{
+    this->jobThreadCount = count;
+}
+
+uint8_t Settings::getJobThreadCount() const
+{
+    if (this->jobThreadCount != 0)
+        return this->jobThreadCount;
+
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return static_cast<uint8_t>(std::clamp(hardwareThreads, 2u, 255u) - 1);
+}
+
+void Settings::setTerrainMode(const TerrainMode mode)
+{
+    this->terrainMode = mode;
+}
+
+TerrainMode Settings::getTerrainMode() const
+{
+    return this->terrainMode;
+}
+
+void Settings::setEntityTickDistances(const std::array<float, 3>& distances)
+{
+    this->entityTickDistances = distances;
+    std::ranges::sort(this->entityTickDistances);
+}
+
+const std::array<float, 3>& Settings::getEntityTickDistances() const
+{
+    return this->entityTickDistances;
+}
+
+void Settings::setEntityRenderDistance(const float distance)
+{
+    this->entityRenderDistance = std::max(distance, 0.f);
+}
+
+float Settings::getEntityRenderDistance() const
+{
+    return this->entityRenderDistance;
+}
\ No newline at end of file
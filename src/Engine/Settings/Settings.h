@@ -1,8 +1,18 @@
 #ifndef FARFIELD_SETTINGS_H
 #define FARFIELD_SETTINGS_H
 
+#include <array>
+#include <thread>
+#include <algorithm>
+
 #include <glm/glm.hpp>
 
+enum class TerrainMode : uint8_t
+{
+    HEIGHTMAP, // 2D height field
+    DENSITY    // 3D density, allows overhangs and caves
+};
+
 class Settings
 {
     // FPS
@@ -17,6 +27,18 @@ class Settings
     // Window settings
     bool fullscreen{false};
 
+    // Worker threads shared by every engine job (0 = one per hardware thread, minus the main thread)
+    uint8_t jobThreadCount{0};
+
+    // World generation
+    TerrainMode terrainMode{TerrainMode::HEIGHTMAP};
+
+    // Distances to the player (blocks) past which entities tick at 1/2, 1/4 and 1/8 rate
+    std::array<float, 3> entityTickDistances{32.f, 64.f, 96.f};
+
+    // Distance to the player (blocks) past which entities aren't drawn
+    float entityRenderDistance{96.f};
+
     public:
         void useVSync(bool use);
         [[nodiscard]] bool isUsingVSync() const;
@@ -33,6 +55,18 @@ class Settings
 
         void setFullscreen(bool full);
         [[nodiscard]] bool isFullscreen() const;
+
+        void setJobThreadCount(uint8_t count);
+        [[nodiscard]] uint8_t getJobThreadCount() const;
+
+        void setTerrainMode(TerrainMode mode);
+        [[nodiscard]] TerrainMode getTerrainMode() const;
+
+        void setEntityTickDistances(const std::array<float, 3>& distances);
+        [[nodiscard]] const std::array<float, 3>& getEntityTickDistances() const;
+
+        void setEntityRenderDistance(float distance);
+        [[nodiscard]] float getEntityRenderDistance() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "SpatialHash.h"
+
+#include <bit>
+
+SpatialHash::SpatialHash(const float _cellSize) :
+    cellSize(_cellSize),
+    inverseCellSize(1.f / _cellSize)
+{}
+
+void SpatialHash::clear()
+{
+    this->entries.clear();
+    this->cellEntries.clear();
+}
+
+void SpatialHash::insert(const ECS::EntityId id, const glm::vec3& min, const glm::vec3& max)
+{
+    this->entries.push_back({id, min, max});
+}
+
+void SpatialHash::build()
+{
+    // Twice as many buckets as entries keeps collisions rare without clearing a large table every rebuild
+    const std::size_t bucketCount = std::bit_ceil(std::max<std::size_t>(16, this->entries.size() * 2));
+    this->bucketMask = static_cast<std::uint32_t>(bucketCount - 1);
+    this->bucketStart.assign(bucketCount + 1, 0);
+    this->scratch.clear();
+
+    for (std::uint32_t index = 0; index < this->entries.size(); ++index) {
+        const Entry& entry = this->entries[index];
+        const glm::ivec3 minCell = this->getCell(entry.min);
+        const glm::ivec3 maxCell = this->getCell(entry.max);
+        const std::size_t first = this->scratch.size();
+
+        for (int z = minCell.z; z <= maxCell.z; ++z)
+            for (int y = minCell.y; y <= maxCell.y; ++y)
+                for (int x = minCell.x; x <= maxCell.x; ++x)
+                    this->scratch.emplace_back(this->getBucket({x, y, z}), index);
+
+        // Cells of an entry can share a bucket, list it once per bucket so queries don't see it twice
+        const auto cells = this->scratch.begin() + static_cast<std::ptrdiff_t>(first);
+        std::sort(cells, this->scratch.end());
+        this->scratch.erase(std::unique(cells, this->scratch.end()), this->scratch.end());
+    }
+
+    // Counting sort by bucket
+    for (const auto& [bucket, index] : this->scratch)
+        this->bucketStart[bucket + 1]++;
+    for (std::size_t b = 0; b < bucketCount; ++b)
+        this->bucketStart[b + 1] += this->bucketStart[b];
+
+    this->cellEntries.resize(this->scratch.size());
+    std::vector<std::uint32_t> cursor(this->bucketStart.begin(), this->bucketStart.end() - 1);
+
+    for (const auto& [bucket, index] : this->scratch)
+        this->cellEntries[cursor[bucket]++] = index;
+}
@@ -0,0 +1,142 @@
+#ifndef FARFIELD_SPATIALHASH_H
+#define FARFIELD_SPATIALHASH_H
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "ECS/IEntity.h"
+
+// Uniform grid broadphase over entity AABBs. Boxes are inserted between clear() and build(),
+// grid cells are hashed into a table sized from the entity count, so memory doesn't depend on the world extent.
+// Queries are const and can run from several threads once built
+class SpatialHash {
+    public:
+        static constexpr float DEFAULT_CELL_SIZE = 2.f;
+
+        struct Entry {
+            ECS::EntityId id;
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
+        explicit SpatialHash(float _cellSize = DEFAULT_CELL_SIZE);
+
+        // Queries see nothing from clear() until the next build()
+        void clear();
+        void insert(ECS::EntityId id, const glm::vec3& min, const glm::vec3& max);
+        void build();
+
+        // Entries overlapping [min, max], touching faces don't count. Every entry is reported once
+        template<typename Fn>
+        void queryBox(const glm::vec3& min, const glm::vec3& max, Fn&& fn) const;
+
+        // Entries whose box gets closer than radius to center
+        template<typename Fn>
+        void queryRadius(const glm::vec3& center, float radius, Fn&& fn) const;
+
+        // Entries overlapping the bounds of the segment, the exact ray test is left to the caller
+        template<typename Fn>
+        void queryRay(const glm::vec3& origin, const glm::vec3& dir, float length, Fn&& fn) const;
+
+        [[nodiscard]] std::size_t size() const { return this->entries.size(); }
+        [[nodiscard]] float getCellSize() const { return this->cellSize; }
+        [[nodiscard]] const std::vector<Entry>& getEntries() const { return this->entries; }
+
+    private:
+        static constexpr float RAY_MARGIN = 1e-3f;
+
+        float cellSize;
+        float inverseCellSize;
+
+        std::vector<Entry> entries;
+        std::vector<std::uint32_t> bucketStart;  // Entries of bucket b are cellEntries[bucketStart[b], bucketStart[b + 1])
+        std::vector<std::uint32_t> cellEntries;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> scratch; // (bucket, entry) pairs of the last build
+        std::uint32_t bucketMask = 0;
+
+        [[nodiscard]] glm::ivec3 getCell(const glm::vec3& pos) const
+        {
+            return glm::ivec3(glm::floor(pos * this->inverseCellSize));
+        }
+
+        [[nodiscard]] std::uint32_t getBucket(const glm::ivec3& cell) const
+        {
+            const auto h = static_cast<std::uint32_t>(cell.x) * 73856093u
+                         ^ static_cast<std::uint32_t>(cell.y) * 19349663u
+                         ^ static_cast<std::uint32_t>(cell.z) * 83492791u;
+            return h & this->bucketMask;
+        }
+};
+
+template<typename Fn>
+void SpatialHash::queryBox(const glm::vec3& min, const glm::vec3& max, Fn&& fn) const
+{
+    if (this->cellEntries.empty())
+        return;
+
+    const glm::ivec3 minCell = this->getCell(min);
+    const glm::ivec3 maxCell = this->getCell(max);
+    const glm::vec3 span = glm::vec3(maxCell - minCell) + 1.f;
+
+    // Past one cell per entry, a linear scan is cheaper than walking the cells
+    if (span.x * span.y * span.z > static_cast<float>(this->entries.size())) {
+        for (const Entry& entry : this->entries)
+            if (entry.min.x < max.x && entry.max.x > min.x &&
+                entry.min.y < max.y && entry.max.y > min.y &&
+                entry.min.z < max.z && entry.max.z > min.z)
+                fn(entry);
+        return;
+    }
+
+    for (int z = minCell.z; z <= maxCell.z; ++z) {
+        for (int y = minCell.y; y <= maxCell.y; ++y) {
+            for (int x = minCell.x; x <= maxCell.x; ++x) {
+                const glm::ivec3 cell{x, y, z};
+                const std::uint32_t bucket = this->getBucket(cell);
+
+                for (std::uint32_t i = this->bucketStart[bucket]; i < this->bucketStart[bucket + 1]; ++i) {
+                    const Entry& entry = this->entries[this->cellEntries[i]];
+
+                    if (entry.min.x >= max.x || entry.max.x <= min.x ||
+                        entry.min.y >= max.y || entry.max.y <= min.y ||
+                        entry.min.z >= max.z || entry.max.z <= min.z)
+                        continue;
+
+                    // An entry spans several cells, only the first cell shared with the query reports it
+                    if (glm::max(this->getCell(entry.min), minCell) != cell)
+                        continue;
+
+                    fn(entry);
+                }
+            }
+        }
+    }
+}
+
+template<typename Fn>
+void SpatialHash::queryRadius(const glm::vec3& center, const float radius, Fn&& fn) const
+{
+    this->queryBox(center - radius, center + radius, [&](const Entry& entry) {
+        const glm::vec3 closest = glm::clamp(center, entry.min, entry.max);
+        const glm::vec3 delta = closest - center;
+
+        if (glm::dot(delta, delta) < radius * radius)
+            fn(entry);
+    });
+}
+
+template<typename Fn>
+void SpatialHash::queryRay(const glm::vec3& origin, const glm::vec3& dir, const float length, Fn&& fn) const
+{
+    const glm::vec3 end = origin + dir * length;
+
+    this->queryBox(glm::min(origin, end) - RAY_MARGIN, glm::max(origin, end) + RAY_MARGIN, std::forward<Fn>(fn));
+}
+
+#endif
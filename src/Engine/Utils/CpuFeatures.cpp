@@ -0,0 +1,34 @@
+#include "CpuFeatures.h"
+#include "SimdTarget.h"
+
+CpuFeatures::SimdLevel CpuFeatures::detectSimdLevel()
+{
+#if defined(FARFIELD_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+
+    bool avx2 = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = osAvx && (info[1] & (1 << 5)) != 0;
+    }
+
+    if (avx2)
+        return SimdLevel::AVX2;
+    if (sse41)
+        return SimdLevel::SSE41;
+#elif defined(FARFIELD_SIMD_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return SimdLevel::SSE41;
+#endif
+    return SimdLevel::SCALAR;
+}
\ No newline at end of file
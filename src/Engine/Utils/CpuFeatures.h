@@ -0,0 +1,28 @@
+#ifndef FARFIELD_CPUFEATURES_H
+#define FARFIELD_CPUFEATURES_H
+
+#include <cstdint>
+
+// Runtime SIMD detection, shared by the kernels that pick a backend per CPU
+namespace CpuFeatures
+{
+    enum class SimdLevel : uint8_t
+    {
+        SCALAR,
+        SSE41,
+        AVX2
+    };
+
+    SimdLevel detectSimdLevel();
+
+    inline const char* getName(const SimdLevel level)
+    {
+        switch (level) {
+            case SimdLevel::AVX2: return "AVX2";
+            case SimdLevel::SSE41: return "SSE4.1";
+            default: return "Scalar";
+        }
+    }
+}
+
+#endif
\ No newline at end of file
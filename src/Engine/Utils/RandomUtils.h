@@ -0,0 +1,73 @@
+#ifndef FARFIELD_RANDOMUTILS_H
+#define FARFIELD_RANDOMUTILS_H
+
+#include <cstdint>
+
+// Counter-based random numbers: every value is a pure hash of (seed, position, salt, index).
+// No state is carried between values, so results don't depend on call order or threads
+namespace RandomUtils
+{
+    // SplitMix64 finalizer
+    constexpr uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ull;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // Key of a stream, each input goes through the mixer so nearby positions don't correlate
+    constexpr uint64_t key(const uint64_t seed, const int x, const int y, const int z, const uint64_t salt)
+    {
+        uint64_t h = mix(seed ^ salt * 0x9E3779B97F4A7C15ull);
+        h = mix(h ^ static_cast<uint32_t>(x));
+        h = mix(h ^ static_cast<uint32_t>(y));
+        h = mix(h ^ static_cast<uint32_t>(z));
+        return h;
+    }
+
+    // Value at index of a stream, what Stream::next walks through
+    constexpr uint64_t at(const uint64_t key, const uint64_t index)
+    {
+        return mix(key + (index + 1) * 0x9E3779B97F4A7C15ull);
+    }
+
+    // Uniform integer in [min, max], multiply-shift range reduction
+    constexpr int toRange(const uint64_t value, const int min, const int max)
+    {
+        const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min + 1);
+        return min + static_cast<int>(((value >> 32) * range) >> 32);
+    }
+
+    // Sequential view of a stream
+    struct Stream
+    {
+        uint64_t key;
+        uint64_t index = 0;
+
+        constexpr uint64_t next()
+        {
+            return at(this->key, this->index++);
+        }
+
+        constexpr int nextInt(const int min, const int max)
+        {
+            return toRange(this->next(), min, max);
+        }
+
+        // [0, 1)
+        constexpr float nextFloat()
+        {
+            return static_cast<float>(this->next() >> 40) * 0x1.0p-24f;
+        }
+    };
+
+    constexpr Stream stream(const uint64_t seed, const int x, const int y, const int z, const uint64_t salt)
+    {
+        return {key(seed, x, y, z, salt)};
+    }
+}
+
+#endif
\ No newline at end of file
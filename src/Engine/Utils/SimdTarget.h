@@ -0,0 +1,18 @@
+#ifndef FARFIELD_SIMDTARGET_H
+#define FARFIELD_SIMDTARGET_H
+
+// Intrinsics for SIMD backends. Backend functions are compiled with FARFIELD_TARGET(isa)
+// so the rest of the build keeps the baseline ISA, callers pick one with CpuFeatures::detectSimdLevel()
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define FARFIELD_SIMD_X86
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define FARFIELD_TARGET(isa)
+    #else
+        #define FARFIELD_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+#endif
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <glm/glm.hpp>
 
 #include "ChunkPos.h"
+#include "RandomUtils.h"
 
 namespace fs = std::filesystem;
 
@@ -26,11 +27,10 @@ namespace Maths
 {
     inline int randomInt(const int min, const int max)
     {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> distrib(min, max);
+        // Seeded once per thread, then counter based
+        thread_local RandomUtils::Stream stream{std::random_device{}()};
 
-        return distrib(gen);
+        return stream.nextInt(min, max);
     }
 
     template <typename T = float>
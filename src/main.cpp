@@ -1,7 +1,7 @@
 #include <Engine.h>
 
-int main() {
-    Engine engine;
+int main(const int argc, char** argv) {
+    Engine engine(EngineOptions::fromArgs(argc, argv));
 
     engine.loop();
     return 0;